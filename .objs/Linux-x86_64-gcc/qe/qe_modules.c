@@ -0,0 +1,143 @@
+/* This file was generated automatically */
+#include "qe.h"
+#undef qe_module_init
+#define qe_module_init(fn)  extern int module_##fn(void)
+qe_module_init(search_init);
+qe_module_init(hex_init);
+qe_module_init(parser_init);
+qe_module_init(extras_init);
+qe_module_init(vars_init);
+qe_module_init(tty_init);
+qe_module_init(charset_jis_init);
+qe_module_init(charset_more_init);
+qe_module_init(unihex_init);
+qe_module_init(bufed_init);
+qe_module_init(org_init);
+qe_module_init(mkd_init);
+qe_module_init(c_init);
+qe_module_init(xml_init);
+qe_module_init(htmlsrc_init);
+qe_module_init(ff_init);
+qe_module_init(arm_modes_init);
+qe_module_init(lisp_init);
+qe_module_init(makefile_init);
+qe_module_init(perl_init);
+qe_module_init(shell_script_init);
+qe_module_init(ebnf_init);
+qe_module_init(cobol_init);
+qe_module_init(r_init);
+qe_module_init(txl_init);
+qe_module_init(nim_init);
+qe_module_init(rebol_init);
+qe_module_init(elm_init);
+qe_module_init(jai_init);
+qe_module_init(ats_init);
+qe_module_init(rust_init);
+qe_module_init(swift_init);
+qe_module_init(icon_init);
+qe_module_init(groovy_init);
+qe_module_init(virgil_init);
+qe_module_init(ada_init);
+qe_module_init(basic_init);
+qe_module_init(vim_init);
+qe_module_init(pascal_init);
+qe_module_init(fortran_init);
+qe_module_init(haskell_init);
+qe_module_init(lua_init);
+qe_module_init(python_init);
+qe_module_init(ruby_init);
+qe_module_init(smalltalk_init);
+qe_module_init(sql_init);
+qe_module_init(elixir_init);
+qe_module_init(agena_init);
+qe_module_init(coffee_init);
+qe_module_init(erlang_init);
+qe_module_init(julia_init);
+qe_module_init(ocaml_init);
+qe_module_init(scad_init);
+qe_module_init(magpie_init);
+qe_module_init(falcon_init);
+qe_module_init(wolfram_init);
+qe_module_init(tiger_init);
+qe_module_init(asm_init);
+qe_module_init(ini_init);
+qe_module_init(ps_init);
+qe_module_init(fractal_init);
+qe_module_init(extra_modes_init);
+qe_module_init(shell_init);
+qe_module_init(dired_init);
+qe_module_init(archive_compress_init);
+qe_module_init(latex_init);
+qe_module_init(stb_init);
+#undef qe_module_init
+void init_all_modules(void) {
+#define qe_module_init(fn)  module_##fn()
+qe_module_init(search_init);
+qe_module_init(hex_init);
+qe_module_init(parser_init);
+qe_module_init(extras_init);
+qe_module_init(vars_init);
+qe_module_init(tty_init);
+qe_module_init(charset_jis_init);
+qe_module_init(charset_more_init);
+qe_module_init(unihex_init);
+qe_module_init(bufed_init);
+qe_module_init(org_init);
+qe_module_init(mkd_init);
+qe_module_init(c_init);
+qe_module_init(xml_init);
+qe_module_init(htmlsrc_init);
+qe_module_init(ff_init);
+qe_module_init(arm_modes_init);
+qe_module_init(lisp_init);
+qe_module_init(makefile_init);
+qe_module_init(perl_init);
+qe_module_init(shell_script_init);
+qe_module_init(ebnf_init);
+qe_module_init(cobol_init);
+qe_module_init(r_init);
+qe_module_init(txl_init);
+qe_module_init(nim_init);
+qe_module_init(rebol_init);
+qe_module_init(elm_init);
+qe_module_init(jai_init);
+qe_module_init(ats_init);
+qe_module_init(rust_init);
+qe_module_init(swift_init);
+qe_module_init(icon_init);
+qe_module_init(groovy_init);
+qe_module_init(virgil_init);
+qe_module_init(ada_init);
+qe_module_init(basic_init);
+qe_module_init(vim_init);
+qe_module_init(pascal_init);
+qe_module_init(fortran_init);
+qe_module_init(haskell_init);
+qe_module_init(lua_init);
+qe_module_init(python_init);
+qe_module_init(ruby_init);
+qe_module_init(smalltalk_init);
+qe_module_init(sql_init);
+qe_module_init(elixir_init);
+qe_module_init(agena_init);
+qe_module_init(coffee_init);
+qe_module_init(erlang_init);
+qe_module_init(julia_init);
+qe_module_init(ocaml_init);
+qe_module_init(scad_init);
+qe_module_init(magpie_init);
+qe_module_init(falcon_init);
+qe_module_init(wolfram_init);
+qe_module_init(tiger_init);
+qe_module_init(asm_init);
+qe_module_init(ini_init);
+qe_module_init(ps_init);
+qe_module_init(fractal_init);
+qe_module_init(extra_modes_init);
+qe_module_init(shell_init);
+qe_module_init(dired_init);
+qe_module_init(archive_compress_init);
+qe_module_init(latex_init);
+qe_module_init(stb_init);
+#undef qe_module_init
+}
@@ -0,0 +1,17 @@
+/* This file was generated automatically */
+#include "qe.h"
+#undef qe_module_init
+#define qe_module_init(fn)  extern int module_##fn(void)
+qe_module_init(search_init);
+qe_module_init(hex_init);
+qe_module_init(parser_init);
+qe_module_init(tty_init);
+#undef qe_module_init
+void init_all_modules(void) {
+#define qe_module_init(fn)  module_##fn()
+qe_module_init(search_init);
+qe_module_init(hex_init);
+qe_module_init(parser_init);
+qe_module_init(tty_init);
+#undef qe_module_init
+}
@@ -68,7 +68,8 @@ static void update_page(Page *p)
         p->data = buf;
         p->flags &= ~PG_READ_ONLY;
     }
-    p->flags &= ~(PG_VALID_POS | PG_VALID_CHAR | PG_VALID_COLORS);
+    p->flags &= ~(PG_VALID_POS | PG_VALID_CHAR | PG_VALID_COLORS |
+                  PG_VALID_RTL);
 }
 
 /* Read one raw byte from the buffer:
@@ -528,6 +529,27 @@ int eb_delete(EditBuffer *b, int offset, int size)
     return size0;
 }
 
+/* Discard the first 'size' bytes of the buffer without undo logging,
+ * to bound the scrollback of process output buffers.  Callbacks see a
+ * normal deletion, so offsets and caches for the remaining contents
+ * are shifted instead of recomputed.  Undo records refer to the
+ * previous offsets and are flushed.
+ * Return actual number of bytes removed.
+ */
+int eb_trim_head(EditBuffer *b, int size)
+{
+    int save_log = b->save_log;
+
+    b->save_log = 0;
+    size = eb_delete(b, 0, size);
+    b->save_log = save_log;
+    if (size > 0) {
+        eb_free_log_buffer(b);
+        b->last_log = 0;
+    }
+    return size;
+}
+
 /*---------------- finding buffers ----------------*/
 
 /* Verify that window still exists, return argument or NULL,
@@ -923,6 +945,9 @@ void eb_trace_bytes(const void *buf, int size, int state)
         case EB_TRACE_DEBUG:
             str = "debug";
             break;
+        case EB_TRACE_DISPLAY:
+            str = "display";
+            break;
         case EB_TRACE_COMMAND:
             str = "command";
             break;
@@ -1203,7 +1228,7 @@ static void eb_addlog(EditBuffer *b, enum LogOperation op,
 
     /* header */
     lb.pad1 = '\n';   /* make log buffer display readable */
-    lb.pad2 = ':';
+    lb.pad2 = (b->save_log & 4) ? '+' : ':';  /* '+' chains to previous */
     lb.op = op;
     lb.offset = offset;
     lb.size = size;
@@ -1261,50 +1286,60 @@ void do_undo(EditState *s)
     } else {
         put_status(s, "Undo!");
     }
-    /* go backward */
-    log_index -= sizeof(int);
-    eb_read(b->log_buffer, log_index, &size_trailer, sizeof(int));
-    log_index -= size_trailer + sizeof(LogBuffer);
-
-    /* log_current is 1 + index to have zero as default value */
-    b->log_current = log_index + 1;
-
-    /* play the log entry */
-    eb_read(b->log_buffer, log_index, &lb, sizeof(LogBuffer));
-    log_index += sizeof(LogBuffer);
+    for (;;) {
+        /* go backward */
+        log_index -= sizeof(int);
+        eb_read(b->log_buffer, log_index, &size_trailer, sizeof(int));
+        log_index -= size_trailer + sizeof(LogBuffer);
+
+        /* log_current is 1 + index to have zero as default value */
+        b->log_current = log_index + 1;
+
+        /* play the log entry */
+        eb_read(b->log_buffer, log_index, &lb, sizeof(LogBuffer));
+        log_index += sizeof(LogBuffer);
+
+        b->last_log = 0;  /* prevent log compression */
+
+        switch (lb.op) {
+        case LOGOP_WRITE:
+            /* we must disable the log because we want to record a single
+               write (we should have the single operation: eb_write_buffer) */
+            b->save_log |= 2;
+            eb_delete(b, lb.offset, lb.size);
+            eb_insert_buffer(b, lb.offset, b->log_buffer, log_index, lb.size);
+            b->save_log &= ~2;
+            eb_addlog(b, LOGOP_WRITE, lb.offset, lb.size);
+            s->offset = lb.offset + lb.size;
+            break;
+        case LOGOP_DELETE:
+            /* we must also disable the log there because the log buffer
+               would be modified BEFORE we insert it by the implicit
+               eb_addlog */
+            b->save_log |= 2;
+            eb_insert_buffer(b, lb.offset, b->log_buffer, log_index, lb.size);
+            b->save_log &= ~2;
+            eb_addlog(b, LOGOP_INSERT, lb.offset, lb.size);
+            s->offset = lb.offset + lb.size;
+            break;
+        case LOGOP_INSERT:
+            eb_delete(b, lb.offset, lb.size);
+            s->offset = lb.offset;
+            break;
+        default:
+            abort();
+        }
+        b->save_log &= ~4;
 
-    b->last_log = 0;  /* prevent log compression */
+        b->modified = lb.was_modified;
 
-    switch (lb.op) {
-    case LOGOP_WRITE:
-        /* we must disable the log because we want to record a single
-           write (we should have the single operation: eb_write_buffer) */
-        b->save_log |= 2;
-        eb_delete(b, lb.offset, lb.size);
-        eb_insert_buffer(b, lb.offset, b->log_buffer, log_index, lb.size);
-        b->save_log &= ~2;
-        eb_addlog(b, LOGOP_WRITE, lb.offset, lb.size);
-        s->offset = lb.offset + lb.size;
-        break;
-    case LOGOP_DELETE:
-        /* we must also disable the log there because the log buffer
-           would be modified BEFORE we insert it by the implicit
-           eb_addlog */
-        b->save_log |= 2;
-        eb_insert_buffer(b, lb.offset, b->log_buffer, log_index, lb.size);
-        b->save_log &= ~2;
-        eb_addlog(b, LOGOP_INSERT, lb.offset, lb.size);
-        s->offset = lb.offset + lb.size;
-        break;
-    case LOGOP_INSERT:
-        eb_delete(b, lb.offset, lb.size);
-        s->offset = lb.offset;
-        break;
-    default:
-        abort();
+        /* undo chained records as a single step, chain the new records */
+        log_index = b->log_current - 1;
+        if (lb.pad2 != '+' || log_index == 0)
+            break;
+        if (b->save_log & 1)
+            b->save_log |= 4;
     }
-
-    b->modified = lb.was_modified;
 }
 
 void do_redo(EditState *s)
@@ -1333,68 +1368,74 @@ void do_redo(EditState *s)
     }
     put_status(s, "Redo!");
 
-    /* go forward in undo stack */
-    log_index = b->log_current - 1;
-    eb_read(b->log_buffer, log_index, &lb, sizeof(LogBuffer));
-    log_index += sizeof(LogBuffer);
-    if (lb.op != LOGOP_INSERT)
-        log_index += lb.size;
-    log_index += sizeof(int);
-    /* log_current is 1 + index to have zero as default value */
-    b->log_current = log_index + 1;
-
-    /* go backward from the end and remove undo record */
-    log_index = b->log_new_index;
-    log_index -= sizeof(int);
-    eb_read(b->log_buffer, log_index, &size_trailer, sizeof(int));
-    log_index -= size_trailer + sizeof(LogBuffer);
-
-    /* play the log entry */
-    eb_read(b->log_buffer, log_index, &lb, sizeof(LogBuffer));
-    log_index += sizeof(LogBuffer);
-
-    switch (lb.op) {
-    case LOGOP_WRITE:
-        /* we must disable the log because we want to record a single
-           write (we should have the single operation: eb_write_buffer) */
-        b->save_log |= 2;
-        eb_delete(b, lb.offset, lb.size);
-        eb_insert_buffer(b, lb.offset, b->log_buffer, log_index, lb.size);
-        b->save_log &= ~3;
-        eb_addlog(b, LOGOP_WRITE, lb.offset, lb.size);
-        b->save_log |= 1;
-        s->offset = lb.offset + lb.size;
-        break;
-    case LOGOP_DELETE:
-        /* we must also disable the log there because the log buffer
-           would be modified BEFORE we insert it by the implicit
-           eb_addlog */
-        b->save_log |= 2;
-        eb_insert_buffer(b, lb.offset, b->log_buffer, log_index, lb.size);
-        b->save_log &= ~3;
-        eb_addlog(b, LOGOP_INSERT, lb.offset, lb.size);
-        b->save_log |= 1;
-        s->offset = lb.offset + lb.size;
-        break;
-    case LOGOP_INSERT:
-        b->save_log &= ~1;
-        eb_delete(b, lb.offset, lb.size);
-        b->save_log |= 1;
-        s->offset = lb.offset;
-        break;
-    default:
-        abort();
-    }
+    for (;;) {
+        /* go forward in undo stack */
+        log_index = b->log_current - 1;
+        eb_read(b->log_buffer, log_index, &lb, sizeof(LogBuffer));
+        log_index += sizeof(LogBuffer);
+        if (lb.op != LOGOP_INSERT)
+            log_index += lb.size;
+        log_index += sizeof(int);
+        /* log_current is 1 + index to have zero as default value */
+        b->log_current = log_index + 1;
+
+        /* go backward from the end and remove undo record */
+        log_index = b->log_new_index;
+        log_index -= sizeof(int);
+        eb_read(b->log_buffer, log_index, &size_trailer, sizeof(int));
+        log_index -= size_trailer + sizeof(LogBuffer);
+
+        /* play the log entry */
+        eb_read(b->log_buffer, log_index, &lb, sizeof(LogBuffer));
+        log_index += sizeof(LogBuffer);
+
+        switch (lb.op) {
+        case LOGOP_WRITE:
+            /* we must disable the log because we want to record a single
+               write (we should have the single operation: eb_write_buffer) */
+            b->save_log |= 2;
+            eb_delete(b, lb.offset, lb.size);
+            eb_insert_buffer(b, lb.offset, b->log_buffer, log_index, lb.size);
+            b->save_log &= ~3;
+            eb_addlog(b, LOGOP_WRITE, lb.offset, lb.size);
+            b->save_log |= 1;
+            s->offset = lb.offset + lb.size;
+            break;
+        case LOGOP_DELETE:
+            /* we must also disable the log there because the log buffer
+               would be modified BEFORE we insert it by the implicit
+               eb_addlog */
+            b->save_log |= 2;
+            eb_insert_buffer(b, lb.offset, b->log_buffer, log_index, lb.size);
+            b->save_log &= ~3;
+            eb_addlog(b, LOGOP_INSERT, lb.offset, lb.size);
+            b->save_log |= 1;
+            s->offset = lb.offset + lb.size;
+            break;
+        case LOGOP_INSERT:
+            b->save_log &= ~1;
+            eb_delete(b, lb.offset, lb.size);
+            b->save_log |= 1;
+            s->offset = lb.offset;
+            break;
+        default:
+            abort();
+        }
 
-    b->modified = lb.was_modified;
+        b->modified = lb.was_modified;
 
-    log_index -= sizeof(LogBuffer);
-    eb_delete(b->log_buffer, log_index, b->log_new_index - log_index);
-    b->log_new_index = log_index;
+        log_index -= sizeof(LogBuffer);
+        eb_delete(b->log_buffer, log_index, b->log_new_index - log_index);
+        b->log_new_index = log_index;
 
-    if (b->log_current >= log_index + 1) {
-        /* redone everything */
-        b->log_current = 0;
+        if (b->log_current >= log_index + 1) {
+            /* redone everything */
+            b->log_current = 0;
+            break;
+        }
+        /* redo chained records as a single step */
+        if (lb.pad2 != '+')
+            break;
     }
 }
 
@@ -1430,7 +1471,8 @@ void eb_set_charset(EditBuffer *b, QECharset *charset, EOLType eol_type)
     /* Reset page cache flags */
     for (n = 0; n < b->nb_pages; n++) {
         Page *p = &b->page_table[n];
-        p->flags &= ~(PG_VALID_POS | PG_VALID_CHAR | PG_VALID_COLORS);
+        p->flags &= ~(PG_VALID_POS | PG_VALID_CHAR | PG_VALID_COLORS |
+                  PG_VALID_RTL);
     }
 }
 
@@ -1753,6 +1795,91 @@ int eb_get_pos(EditBuffer *b, int *line_ptr, int *col_ptr, int offset)
 /************************************************************/
 /* char offset computation */
 
+/* code points with a strong right to left or an explicit bidi class:
+ * Hebrew, Arabic, Syriac, Thaana, NKo..., RLM, embeddings, overrides
+ * and isolates, presentation forms and the RTL scripts of the SMP.
+ */
+static int is_rtl_class(unsigned int c)
+{
+    if (c < 0x0590)
+        return 0;
+    return (c <= 0x08FF)
+        || (c == 0x200F)
+        || (c >= 0x202A && c <= 0x202E)
+        || (c >= 0x2066 && c <= 0x2069)
+        || (c >= 0xFB1D && c <= 0xFDFF)
+        || (c >= 0xFE70 && c <= 0xFEFF)
+        || (c >= 0x10800 && c <= 0x10FFF)
+        || (c >= 0x1E800 && c <= 0x1EFFF);
+}
+
+/* scan a page for right to left text, skip ASCII text a word at a time */
+static int page_has_rtl(EditBuffer *b, const u8 *p, int size)
+{
+    const u8 *p_end = p + size;
+    const char *q;
+    uint64_t w;
+
+    if (b->charset == &charset_8859_1 || b->charset == &charset_raw)
+        return 0;
+    if (b->charset != &charset_utf8)
+        return 1;
+
+    while (p < p_end) {
+        if (p_end - p >= 8) {
+            memcpy(&w, p, 8);
+            if (!(w & 0x8080808080808080ULL)) {
+                p += 8;
+                continue;
+            }
+        }
+        /* right to left code points start at U+0590, lead byte 0xD6 */
+        if (*p < 0xD6) {
+            p++;
+            continue;
+        }
+        q = (const char *)p;
+        if (p_end - p < 4) {
+            /* decoding could read past the page */
+            return 1;
+        }
+        if (is_rtl_class(utf8_decode(&q)))
+            return 1;
+        p = (const u8 *)q;
+    }
+    return 0;
+}
+
+/* return true if the line starting at offset may contain right to left
+ * text, per page.  Lines within pages of left to right text do not need
+ * bidir analysis.
+ */
+int eb_line_has_rtl(EditBuffer *b, int offset)
+{
+    Page *p, *p_end;
+
+    if (offset >= b->total_size)
+        return 0;
+
+    p = find_page(b, offset, &offset);
+    p_end = b->page_table + b->nb_pages;
+    for (; p < p_end; p++) {
+        if (!(p->flags & PG_VALID_RTL)) {
+            p->flags |= PG_VALID_RTL;
+            p->flags &= ~PG_HAS_RTL;
+            if (page_has_rtl(b, p->data, p->size))
+                p->flags |= PG_HAS_RTL;
+        }
+        if (p->flags & PG_HAS_RTL)
+            return 1;
+        /* stop at the end of the line */
+        if (memchr(p->data + offset, '\n', p->size - offset))
+            break;
+        offset = 0;
+    }
+    return 0;
+}
+
 /* convert a char number into a byte offset according to buffer charset */
 int eb_goto_char(EditBuffer *b, int pos)
 {
@@ -1863,6 +1990,99 @@ int eb_replace(EditBuffer *b, int offset, int size,
     }
 }
 
+/* Move all pages of 'src' into 'dest' at offset 'offset'. No callbacks
+ * are called, no undo record is produced, 'src' is left empty.
+ */
+static void eb_move_pages(EditBuffer *dest, int offset, EditBuffer *src)
+{
+    Page *p;
+    int i, n, page_index, page_offset;
+
+    /* split the destination page at 'offset' if needed */
+    if (offset < dest->total_size) {
+        p = find_page(dest, offset, &page_offset);
+        page_index = p - dest->page_table;
+        if (page_offset > 0) {
+            eb_insert1(dest, page_index + 1, p->data + page_offset,
+                       p->size - page_offset);
+            /* reload p because page_table may have been reallocated */
+            p = dest->page_table + page_index;
+            update_page(p);
+            p->size = page_offset;
+            qe_realloc(&p->data, p->size);
+            page_index++;
+        }
+    } else {
+        page_index = dest->nb_pages;
+    }
+
+    n = src->nb_pages;
+    if (n > 0) {
+        /* read only pages may refer to a mapping owned by 'src' */
+        for (i = 0; i < n; i++) {
+            if (src->page_table[i].flags & PG_READ_ONLY)
+                update_page(&src->page_table[i]);
+        }
+        qe_realloc(&dest->page_table, (dest->nb_pages + n) * sizeof(Page));
+        p = dest->page_table + page_index;
+        memmove(p + n, p, (dest->nb_pages - page_index) * sizeof(Page));
+        memcpy(p, src->page_table, n * sizeof(Page));
+        dest->nb_pages += n;
+        dest->total_size += src->total_size;
+        qe_free(&src->page_table);
+        src->nb_pages = 0;
+        src->total_size = 0;
+        src->cur_page = NULL;
+    }
+    /* the page cache is no longer valid */
+    dest->cur_page = NULL;
+}
+
+/* replace 'size' bytes at offset 'offset' with the contents of 'src'.
+ * The pages of 'src' are moved into 'b' and 'src' is left empty.
+ * The change is notified as a single deletion followed by a single
+ * insertion, chained together as one undo step.
+ * return the number of bytes inserted
+ */
+int eb_replace_buffer(EditBuffer *b, int offset, int size, EditBuffer *src)
+{
+    int size1 = src->total_size;
+
+    if (b->flags & BF_READONLY)
+        return 0;
+
+    if (offset < 0 || offset > b->total_size)
+        return 0;
+
+    if (size > b->total_size - offset)
+        size = b->total_size - offset;
+
+    eb_delete(b, offset, size);
+
+    if (size1 <= 0)
+        return 0;
+
+    eb_move_pages(b, offset, src);
+
+    /* chain the insertion to the deletion in the undo log, callbacks
+       see the inserted contents */
+    if (b->save_log & 1)
+        b->save_log |= 4;
+    eb_addlog(b, LOGOP_INSERT, offset, size1);
+    b->save_log &= ~4;
+
+    if (b->b_styles && src->b_styles && b->style_shift == src->style_shift) {
+        /* replace the default styles set by the style callback */
+        int style_offset = (offset >> b->char_shift) << b->style_shift;
+        eb_delete(b->b_styles, style_offset, src->b_styles->total_size);
+        eb_move_pages(b->b_styles, style_offset, src->b_styles);
+    }
+
+    /* prevent coalescing further insertions with this undo record */
+    b->last_log = 0;
+    return size1;
+}
+
 /************************************************************/
 /* buffer I/O */
 
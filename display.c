@@ -262,6 +262,20 @@ QEDisplay *probe_display(void)
     return dpy;
 }
 
+void qe_stat_add(QEDisplayStat *st, int start_usec)
+{
+    unsigned int usec = get_clock_usec() - start_usec;
+    int n;
+
+    for (n = 0; n < QE_STAT_HIST_SIZE - 1 && (usec >> n); n++)
+        continue;
+    st->hist[n]++;
+    st->count++;
+    st->total_usec += usec;
+    if (st->max_usec < usec)
+        st->max_usec = usec;
+}
+
 int screen_init(QEditScreen *s, QEDisplay *dpy, int w, int h)
 {
     s->dpy = dpy ? *dpy : dummy_dpy;
@@ -101,6 +101,19 @@ typedef struct QEPicture {
     int tcolor;
 } QEPicture;
 
+/* display profiling: cumulative times and a log2 histogram */
+#define QE_STAT_HIST_SIZE  20
+
+typedef struct QEDisplayStat {
+    unsigned int count;
+    unsigned int max_usec;
+    int64_t total_usec;
+    /* hist[n] counts the times in [2^(n-1), 2^n) microseconds */
+    unsigned int hist[QE_STAT_HIST_SIZE];
+} QEDisplayStat;
+
+void qe_stat_add(QEDisplayStat *st, int start_usec);
+
 typedef struct QEditScreen QEditScreen;
 typedef struct QEDisplay QEDisplay;
 
@@ -164,6 +177,7 @@ struct QEditScreen {
     /* clip region handling */
     int clip_x1, clip_y1;
     int clip_x2, clip_y2;
+    QEDisplayStat flush_stat;
     void *priv_data;
 };
 
@@ -179,7 +193,9 @@ static inline void dpy_close(QEditScreen *s)
 
 static inline void dpy_flush(QEditScreen *s)
 {
+    int start_usec = get_clock_usec();
     s->dpy.dpy_flush(s);
+    qe_stat_add(&s->flush_stat, start_usec);
 }
 
 static inline QEFont *open_font(QEditScreen *s,
@@ -1522,9 +1522,14 @@ static void do_describe_window(EditState *s, int argval)
     if (s->last_buffer)
         eb_printf(b1, "%*s: %s\n", w, "last_buffer", s->last_buffer->name);
     eb_printf(b1, "%*s: %s\n", w, "mode", s->mode->name);
-    eb_printf(b1, "%*s: %d\n", w, "colorize_nb_lines", s->colorize_nb_lines);
-    eb_printf(b1, "%*s: %d\n", w, "colorize_nb_valid_lines", s->colorize_nb_valid_lines);
-    eb_printf(b1, "%*s: %d\n", w, "colorize_max_valid_offset", s->colorize_max_valid_offset);
+    if (s->colorize_cache) {
+        QEColorizeCache *cc = s->colorize_cache;
+        eb_printf(b1, "%*s: %d\n", w, "colorize_ref_count", cc->ref_count);
+        eb_printf(b1, "%*s: %d\n", w, "colorize_nb_lines", cc->colorize_nb_lines);
+        eb_printf(b1, "%*s: %d\n", w, "colorize_nb_valid_lines", cc->colorize_nb_valid_lines);
+        eb_printf(b1, "%*s: %d\n", w, "colorize_max_valid_offset", cc->colorize_max_valid_offset);
+        eb_printf(b1, "%*s: %d\n", w, "colorize_pending", cc->colorize_pending);
+    }
     eb_printf(b1, "%*s: %d\n", w, "busy", s->busy);
     eb_printf(b1, "%*s: %d\n", w, "display_invalid", s->display_invalid);
     eb_printf(b1, "%*s: %d\n", w, "borders_invalid", s->borders_invalid);
@@ -1565,6 +1570,80 @@ static void do_describe_screen(EditState *e, int argval)
     show_popup(e, b1, "Screen Description");
 }
 
+static void describe_display_stat(EditBuffer *b1, const char *name,
+                                  const QEDisplayStat *st)
+{
+    int n, col;
+
+    if (st->count == 0)
+        return;
+    eb_printf(b1, "%14s  %8u  %10lld  %6lld  %7u\n", name, st->count,
+              (long long)st->total_usec,
+              (long long)(st->total_usec / st->count), st->max_usec);
+    for (n = 0; n < QE_STAT_HIST_SIZE && st->hist[n] == 0; n++)
+        continue;
+    if (n == QE_STAT_HIST_SIZE) {
+        /* counted but not timed */
+        return;
+    }
+    col = eb_printf(b1, "%14s ", "");
+    for (n = 0; n < QE_STAT_HIST_SIZE; n++) {
+        if (st->hist[n] == 0)
+            continue;
+        if (col >= 64) {
+            eb_printf(b1, "\n");
+            col = eb_printf(b1, "%14s ", "");
+        }
+        col += eb_printf(b1, " <%d:%u", 1 << n, st->hist[n]);
+    }
+    eb_printf(b1, "\n");
+}
+
+static void do_describe_display_stats(EditState *s, int argval)
+{
+    static const char * const stat_names[QE_STAT_NB] = {
+        "window", "line", "colorize", "bidir",
+        "glyphs", "flush_line", "get_pos",
+    };
+    QEmacsState *qs = s->qe_state;
+    EditBuffer *b1;
+    EditState *e;
+    int i, n;
+
+    if (argval != NO_ARG) {
+        /* reset the statistics */
+        memset(&qs->display_stat, 0, sizeof(qs->display_stat));
+        memset(&s->screen->flush_stat, 0, sizeof(s->screen->flush_stat));
+        for (e = qs->first_window; e != NULL; e = e->next_window)
+            memset(e->display_stats, 0, sizeof(e->display_stats));
+        put_status(s, "Display statistics reset");
+        return;
+    }
+
+    b1 = new_help_buffer();
+    if (!b1)
+        return;
+
+    eb_printf(b1, "\nDisplay statistics (times in microseconds):\n\n");
+    eb_printf(b1, "%14s  %8s  %10s  %6s  %7s\n",
+              "stage", "count", "total", "avg", "max");
+    describe_display_stat(b1, "edit_display", &qs->display_stat);
+    describe_display_stat(b1, "dpy_flush", &s->screen->flush_stat);
+
+    if (!qs->display_stats_timing) {
+        eb_printf(b1, "\nWindow stages are not timed, "
+                  "set display-stats-timing to time them.\n");
+    }
+    for (n = 0, e = qs->first_window; e != NULL; e = e->next_window, n++) {
+        eb_printf(b1, "\nWindow %d: %s (%s)\n", n, e->b->name, e->mode->name);
+        for (i = 0; i < QE_STAT_NB; i++)
+            describe_display_stat(b1, stat_names[i], &e->display_stats[i]);
+    }
+    eb_putc(b1, '\n');
+
+    show_popup(s, b1, "Display Statistics");
+}
+
 /*---------------- buffer contents sorting ----------------*/
 
 struct chunk_ctx {
@@ -1597,7 +1676,7 @@ static int chunk_cmp(void *vp0, const void *vp1, const void *vp2) {
     const struct chunk *p2 = vp2;
     int pos1, pos2;
 
-    if ((++cp->ncmp & 8191) == 8191) {
+    if ((++cp->ncmp & 8191) == 8191 && edit_display_due(&qe_state)) {
         QEmacsState *qs = &qe_state;
         put_status(NULL, "Sorting: %d%%", (int)((cp->ncmp * 90LL) / cp->total_cmp));
         dpy_flush(qs->screen);
@@ -1782,7 +1861,8 @@ static int eb_sort_span(EditBuffer *b, int *pp1, int *pp2, int cur_offset, int f
                                  chunk_array[i].end - chunk_array[i].start);
         // XXX: style issue. Should include newline from source buffer
         eb_putc(b1, '\n');
-        if ((i & 8191) == 8191 && !(flags & SF_SILENT)) {
+        if ((i & 8191) == 8191 && !(flags & SF_SILENT)
+        &&  edit_display_due(&qe_state)) {
             QEmacsState *qs = &qe_state;
             put_status(NULL, "Sorting: %d%%", (int)(90 + i * 10LL / lines));
             dpy_flush(qs->screen);
@@ -2272,6 +2352,9 @@ static const CmdDef extra_commands[] = {
     CMD2( "describe-buffer", "C-h C-b",
           "Show information about the current buffer",
           do_describe_buffer, ESi, "p")
+    CMD2( "describe-display-stats", "C-h p",
+          "Show display profiling statistics, reset them with an argument",
+          do_describe_display_stats, ESi, "P")
     CMD2( "describe-function", "C-h f",
           "Show information and bindings for a command",
           do_describe_function, ESs,
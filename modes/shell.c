@@ -31,9 +31,17 @@
 #include <time.h>
 #include <sys/wait.h>
 #include <sys/ioctl.h>
+#include <sys/stat.h>
 #include <termios.h>
 #include "qe.h"
 
+#ifdef CONFIG_MMAP
+#include <sys/mman.h>
+#endif
+#ifdef CONFIG_THREADS
+#include <pthread.h>
+#endif
+
 /* XXX: status line */
 /* XXX: better tab handling */
 /* XXX: send real cursor position (CSI n) */
@@ -51,6 +59,17 @@ enum QETermState {
     QE_TERM_STATE_STRING,
 };
 
+/* A row of the screen grid: `start` is the offset where scanning the
+ * row resumes at column `x`, `bol` is the offset of its first glyph.
+ * They differ when a wide glyph wraps to the row.
+ */
+typedef struct ShellRow {
+    int start;
+    int bol;
+    int x;
+    int flags;      /* SP_LINE_START_WRAP flags of the row */
+} ShellRow;
+
 typedef struct ShellState {
     QEModeData base;
     /* buffer state */
@@ -75,6 +94,10 @@ typedef struct ShellState {
     unsigned char term_buf[256];
     int term_len, term_pos;
     int utf8_len;
+    /* screen grid index: rows from the top of the screen, computed
+     * lazily and truncated by buffer modifications */
+    ShellRow *grid;
+    int grid_rows, grid_size, grid_cols;
     EditBuffer *b;
     EditBuffer *b_color; /* color buffer, one byte per char */
     struct QEmacsState *qe_state;
@@ -497,9 +520,180 @@ static inline void qe_term_set_style(ShellState *s) {
     s->b->cur_style = QE_TERM_COMPOSITE | s->attr | composite_color;
 }
 
+typedef struct ShellPos {
+    int screen_start; /* offset of the start of row 0 */
+    int line_start; /* offset of the start of current row */
+    int offset;     /* offset of the glyph */
+    int line_end;   /* offset of the newline or the first character that wraps */
+    int row;        /* row of the target offset */
+    int col;        /* column of the target (0 based, newline may have col == s->cols) */
+    int end_col;    /* column of the end of line_end */
+    int flags;
+#define SP_SCREEN_START_WRAP  1
+#define SP_LINE_START_WRAP1   2
+#define SP_LINE_START_WRAP2   4
+#define SP_LINE_START_WRAP    6
+#define SP_LINE_END_WRAP1     8
+#define SP_LINE_END_WRAP2     16
+#define SP_LINE_END_WRAP      24
+} ShellPos;
+
+/* drop the grid rows whose start may depend on the modified contents */
+static void qe_term_grid_callback(qe__unused__ EditBuffer *b, void *opaque,
+                                  qe__unused__ int arg,
+                                  enum LogOperation op,
+                                  int offset, qe__unused__ int size)
+{
+    ShellState *s = opaque;
+
+    if (op == LOGOP_FREE) {
+        s->grid_rows = 0;
+        return;
+    }
+    while (s->grid_rows > 0 && s->grid[s->grid_rows - 1].start >= offset)
+        s->grid_rows--;
+}
+
+static int qe_term_grid_add(ShellState *s, int start, int bol, int x, int flags)
+{
+    ShellRow *row;
+
+    if (s->grid_rows >= s->grid_size) {
+        int size = max(64, s->grid_size * 2);
+        if (!qe_realloc(&s->grid, size * sizeof(*s->grid)))
+            return 0;
+        s->grid_size = size;
+    }
+    row = &s->grid[s->grid_rows++];
+    row->start = start;
+    row->bol = bol;
+    row->x = x;
+    row->flags = flags;
+    return 1;
+}
+
+/* scan the last grid row and add the next one, return 0 at end of buffer */
+static int qe_term_grid_scan(ShellState *s)
+{
+    const ShellRow *row = &s->grid[s->grid_rows - 1];
+    int offset, offset0, offset1, c, x, w;
+
+    offset = row->start;
+    x = row->x;
+    while (offset < s->b->total_size) {
+        offset0 = offset;
+        c = eb_nextc(s->b, offset, &offset);
+        if (c == '\n') {
+            return qe_term_grid_add(s, offset, offset, 0, 0);
+        } else
+        if (c == '\t') {
+            w = (x + 8) & ~7;
+            /* TAB at EOL does not move the cursor */
+            x = min(x + w, s->cols - 1);
+        } else {
+            w = unicode_tty_glyph_width(c);
+            x += w;
+            if (x >= s->cols) {
+                /* handle line wrapping */
+                if (x > s->cols) {
+                    /* wide character at EOL actually wraps to next line */
+                    return qe_term_grid_add(s, offset, offset0, w,
+                                            row->flags | SP_LINE_START_WRAP2);
+                }
+                /* aggregate all accents */
+                while (qe_isaccent(c = eb_nextc(s->b, offset, &offset1)))
+                    offset = offset1;
+                if (c != '\n') {
+                    return qe_term_grid_add(s, offset, offset, 0,
+                                            row->flags | SP_LINE_START_WRAP1);
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+/* find the grid row starting at `offset`, -1 if not indexed */
+static int qe_term_grid_lookup(ShellState *s, int offset)
+{
+    int lo = 0, hi = s->grid_rows;
+
+    while (lo < hi) {
+        int mid = (lo + hi) >> 1;
+        if (s->grid[mid].start < offset)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo < s->grid_rows && s->grid[lo].bol == offset)
+        return lo;
+    return -1;
+}
+
+/* make the grid start at the top of the screen */
+static int qe_term_grid_sync(ShellState *s, int start_offset)
+{
+    int k, r;
+
+    if (s->grid_cols != s->cols) {
+        s->grid_cols = s->cols;
+        s->grid_rows = 0;
+    }
+    if (s->grid_rows > 0 && s->grid[0].start != start_offset) {
+        /* the screen scrolled: keep the rows below the new top */
+        k = qe_term_grid_lookup(s, start_offset);
+        if (k > 0) {
+            s->grid_rows -= k;
+            memmove(s->grid, s->grid + k, s->grid_rows * sizeof(*s->grid));
+            s->grid[0].start = start_offset;
+            s->grid[0].x = 0;
+            s->grid[0].flags = 0;
+            /* recompute the wrap flags inherited from the rows above,
+               down to the first row following a newline */
+            for (r = 1; r < s->grid_rows && s->grid[r].flags; r++) {
+                s->grid[r].flags = s->grid[r - 1].flags |
+                    (s->grid[r].bol != s->grid[r].start ?
+                     SP_LINE_START_WRAP2 : SP_LINE_START_WRAP1);
+            }
+        } else {
+            s->grid_rows = 0;
+        }
+    }
+    if (s->grid_rows == 0)
+        return qe_term_grid_add(s, start_offset, start_offset, 0, 0);
+    return 1;
+}
+
+/* return the screen row containing `offset`, -1 if out of memory */
+static int qe_term_grid_find(ShellState *s, int start_offset, int offset)
+{
+    int lo, hi;
+
+    if (!qe_term_grid_sync(s, start_offset))
+        return -1;
+    while (s->grid[s->grid_rows - 1].start < offset && qe_term_grid_scan(s))
+        continue;
+    for (lo = 0, hi = s->grid_rows - 1; lo < hi;) {
+        int mid = (lo + hi + 1) >> 1;
+        if (s->grid[mid].start <= offset)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return lo;
+}
+
 /* return offset of the n-th terminal line from a given offset */
 static int qe_term_skip_lines(ShellState *s, int offset, int n) {
-    int x, y, w, offset1, offset2;
+    int x, y, w, offset1, offset2, k;
+
+    if (n > 0 && (k = qe_term_grid_lookup(s, offset)) >= 0) {
+        while (s->grid_rows <= k + n && qe_term_grid_scan(s))
+            continue;
+        if (k + n < s->grid_rows)
+            return s->grid[k + n].bol;
+        return s->b->total_size;
+    }
     x = y = 0;
     while (y < n && offset < s->b->total_size) {
         int c = eb_nextc(s->b, offset, &offset1);
@@ -539,28 +733,11 @@ static int qe_term_skip_lines(ShellState *s, int offset, int n) {
     return offset;
 }
 
-typedef struct ShellPos {
-    int screen_start; /* offset of the start of row 0 */
-    int line_start; /* offset of the start of current row */
-    int offset;     /* offset of the glyph */
-    int line_end;   /* offset of the newline or the first character that wraps */
-    int row;        /* row of the target offset */
-    int col;        /* column of the target (0 based, newline may have col == s->cols) */
-    int end_col;    /* column of the end of line_end */
-    int flags;
-#define SP_SCREEN_START_WRAP  1
-#define SP_LINE_START_WRAP1   2
-#define SP_LINE_START_WRAP2   4
-#define SP_LINE_START_WRAP    6
-#define SP_LINE_END_WRAP1     8
-#define SP_LINE_END_WRAP2     16
-#define SP_LINE_END_WRAP      24
-} ShellPos;
-
 #define SP_NO_UPDATE  1
 static int qe_term_get_pos2(ShellState *s, int destoffset, ShellPos *spp, int flags) {
     int offset, offset0, offset1, start_offset, line_offset;
     int c, x, y, w, gpflags;
+    const ShellRow *row;
 
     if (s->use_alternate_screen) {
         start_offset = minp(&s->alternate_screen_top, s->b->total_size);
@@ -570,8 +747,19 @@ static int qe_term_get_pos2(ShellState *s, int destoffset, ShellPos *spp, int fl
     if (spp) {
         gpflags = 0;
         destoffset = clamp(destoffset, 0, s->b->total_size);
-        offset = offset0 = line_offset = start_offset;
-        for (x = y = 0; offset < destoffset;) {
+        offset = line_offset = start_offset;
+        x = y = 0;
+        /* resume from the start of the row containing destoffset */
+        if ((y = qe_term_grid_find(s, start_offset, destoffset)) >= 0) {
+            row = &s->grid[y];
+            offset = line_offset = row->start;
+            x = row->x;
+            gpflags = row->flags;
+        } else {
+            y = 0;
+        }
+        offset0 = offset;
+        while (offset < destoffset) {
             offset0 = offset;
             c = eb_nextc(s->b, offset, &offset);
             if (c == '\n') {
@@ -680,6 +868,7 @@ static int qe_term_get_pos2(ShellState *s, int destoffset, ShellPos *spp, int fl
 static int qe_term_get_pos(ShellState *s, int destoffset, int *px, int *py) {
     int offset, offset1, c;
     int x, y, w, start_offset;
+    const ShellRow *row;
 
     if (s->use_alternate_screen) {
         start_offset = minp(&s->alternate_screen_top, s->b->total_size);
@@ -689,7 +878,16 @@ static int qe_term_get_pos(ShellState *s, int destoffset, int *px, int *py) {
     if (px || py) {
         destoffset = clamp(destoffset, 0, s->b->total_size);
         offset = start_offset;
-        for (x = y = 0; offset < destoffset;) {
+        x = 0;
+        /* resume from the start of the row containing destoffset */
+        if ((y = qe_term_grid_find(s, start_offset, destoffset)) >= 0) {
+            row = &s->grid[y];
+            offset = row->start;
+            x = row->x;
+        } else {
+            y = 0;
+        }
+        while (offset < destoffset) {
             c = eb_nextc(s->b, offset, &offset);
             if (c == '\n') {
                 y++;
@@ -789,6 +987,13 @@ static int qe_term_goto_pos(ShellState *s, int offset, int destx, int desty, int
 
     x = y = 0;
     offset = start_offset;
+    if (desty > 0 && qe_term_grid_sync(s, start_offset)) {
+        /* skip to the start of the destination row or the last one */
+        while (s->grid_rows <= desty && qe_term_grid_scan(s))
+            continue;
+        y = min(desty, s->grid_rows - 1);
+        offset = s->grid[y].bol;
+    }
     while (y < desty || x < destx) {
         if (offset >= s->b->total_size) {
             // XXX: inefficient: should only test if '\n'
@@ -2308,8 +2513,116 @@ static void qe_term_emulate(ShellState *s, int c)
     qe_term_update_cursor(s);
 }
 
+/* Fast path for runs of printable characters in QE_TERM_STATE_NORM:
+ * append the run at the end of the buffer or overwrite plain ASCII
+ * contents in a single buffer operation with the current style.
+ * Return the number of bytes handled, 0 if the run must go through
+ * qe_term_emulate().
+ */
+static int qe_term_emulate_run(ShellState *s, const unsigned char *buf, int len)
+{
+    unsigned char old[256];
+    int i, n, clen, last, offset;
+
+    if (s->state != QE_TERM_STATE_NORM || s->shifted)
+        return 0;
+
+    offset = clampp(&s->cur_offset, 0, s->b->total_size);
+    last = 0;
+    if (offset == s->b->total_size) {
+        /* append: group complete UTF-8 sequences as the state machine
+         * would, leave incomplete or interrupted ones to it.
+         */
+        int is_utf8 = (s->b->charset == &charset_utf8);
+        for (n = 0; n < len; n += clen) {
+            if (buf[n] < 32)
+                break;
+            clen = 1;
+            if (is_utf8 && (clen = utf8_length[buf[n]]) > 1) {
+                if (n + clen > len)
+                    break;
+                for (i = 1; i < clen && buf[n + i] >= 32; i++)
+                    continue;
+                if (i < clen)
+                    break;
+            }
+            last = n;
+        }
+        if (n == 0)
+            return 0;
+        qe_term_set_style(s);
+        eb_insert(s->b, offset, buf, n);
+    } else {
+        /* overwrite: only ASCII over ASCII on the same row */
+        n = min(len, countof(old) - 1);
+        clen = eb_read(s->b, offset, old, n + 1);
+        for (i = 0; i < clen && old[i] >= 32 && old[i] < 127; i++)
+            continue;
+        if (i < clen && old[i] >= 128) {
+            /* the last old character may carry combining accents */
+            i--;
+        }
+        n = min(i, n);
+        for (i = 0; i < n && buf[i] >= 32 && buf[i] < 127; i++)
+            continue;
+        if ((n = i) <= 0)
+            return 0;
+        last = n - 1;
+        qe_term_set_style(s);
+        eb_write(s->b, offset, buf, n);
+    }
+    if (buf[last] < 128) {
+        s->lastc = buf[last];
+    } else {
+        const char *p = cs8(buf + last);
+        s->lastc = (s->b->charset == &charset_utf8) ? utf8_decode(&p) : buf[last];
+    }
+    s->cur_offset = offset + n;
+    return n;
+}
+
 /* buffer related functions */
 
+#define SHELL_TRIM_CHUNK  (16 * MAX_PAGE_SIZE)
+
+/* Bound the scrollback of process output buffers: when the buffer
+ * exceeds shell-scrollback-lines or shell-scrollback-size by a chunk,
+ * trim whole lines from the front.  The terminal screen is kept.
+ */
+static void shell_trim_scrollback(ShellState *s)
+{
+    QEmacsState *qs = s->qe_state;
+    EditBuffer *b = s->b;
+    int size, nb_lines, col, top;
+
+    size = 0;
+    if (qs->shell_scrollback_size > 0)
+        size = b->total_size - qs->shell_scrollback_size;
+    if (qs->shell_scrollback_lines > 0 && b->total_size > SHELL_TRIM_CHUNK) {
+        eb_get_pos(b, &nb_lines, &col, b->total_size);
+        if (nb_lines > qs->shell_scrollback_lines) {
+            size = max(size, eb_goto_pos(b, nb_lines - qs->shell_scrollback_lines, 0));
+        }
+    }
+    /* trim in chunks to amortize the page table update */
+    if (size < max(SHELL_TRIM_CHUNK, b->total_size >> 4))
+        return;
+
+    top = s->screen_top;
+    if (s->use_alternate_screen)
+        top = min(top, s->alternate_screen_top);
+    size = min(size, top);
+    if (size <= 0)
+        return;
+    size = eb_next_line(b, eb_goto_bol(b, size - 1));
+    if (size > top)
+        return;
+
+    size = eb_trim_head(b, size);
+    if (strequal(error_buffer, b->name))
+        error_offset = max(error_offset - size, -1);
+}
+
 /* called when characters are available from the process */
 static void shell_read_cb(void *opaque)
 {
@@ -2317,7 +2630,7 @@ static void shell_read_cb(void *opaque)
     QEmacsState *qs;
     EditBuffer *b;
     unsigned char buf[16 * 1024];
-    int len, i, save_readonly;
+    int len, i, n, save_readonly;
 
     if (!s || s->base.mode != &shell_mode)
         return;
@@ -2338,8 +2651,13 @@ static void shell_read_cb(void *opaque)
 
     if (s->shell_flags & SF_COLOR) {
         /* optional terminal emulation (shell, ssh, make, latex, man modes) */
-        for (i = 0; i < len; i++) {
-            qe_term_emulate(s, buf[i]);
+        for (i = 0; i < len;) {
+            /* only control and escape sequences go through the state machine */
+            if (buf[i] >= 32 && (n = qe_term_emulate_run(s, buf + i, len - i)) > 0) {
+                i += n;
+            } else {
+                qe_term_emulate(s, buf[i++]);
+            }
         }
         if (s->last_char == '\000' || s->last_char == '\001'
         ||  s->last_char == '\003'
@@ -2358,6 +2676,8 @@ static void shell_read_cb(void *opaque)
                 b->mark = s->cur_prompt;
             }
         }
+        if (qs->shell_scrollback_lines > 0 || qs->shell_scrollback_size > 0)
+            shell_trim_scrollback(s);
         shell_get_curpath(b, s->cur_offset, s->curpath, sizeof(s->curpath));
     } else {
         int pos = b->total_size;
@@ -2380,9 +2700,8 @@ static void shell_read_cb(void *opaque)
         b->flags |= save_readonly;
     }
 
-    /* now we do some refresh (should just invalidate?) */
-    edit_display(qs);
-    dpy_flush(qs->screen);
+    /* now we do some refresh */
+    edit_display_request(qs);
 }
 
 static void shell_mode_free(EditBuffer *b, void *state)
@@ -2394,6 +2713,8 @@ static void shell_mode_free(EditBuffer *b, void *state)
     eb_free_callback(b, eb_offset_callback, &s->cur_prompt);
     eb_free_callback(b, eb_offset_callback, &s->alternate_screen_top);
     eb_free_callback(b, eb_offset_callback, &s->screen_top);
+    eb_free_callback(b, qe_term_grid_callback, s);
+    qe_free(&s->grid);
 
     if (s->pid != -1) {
         kill(s->pid, SIGINT);
@@ -2542,6 +2863,7 @@ EditBuffer *new_shell_buffer(EditBuffer *b0, EditState *e,
         eb_add_callback(b, eb_offset_callback, &s->cur_prompt, 0);
         eb_add_callback(b, eb_offset_callback, &s->alternate_screen_top, 0);
         eb_add_callback(b, eb_offset_callback, &s->screen_top, 0);
+        eb_add_callback(b, qe_term_grid_callback, s, 0);
     }
     s->b = b;
     s->pty_fd = -1;
@@ -3322,6 +3644,475 @@ static void do_compile(EditState *s, const char *cmd)
     set_error_offset(b, 0);
 }
 
+/*---------------- grep-files ----------------*/
+
+/* Files are enumerated by time slices in the main thread, searched by
+ * a pool of worker threads and the matching lines are appended to the
+ * *grep* buffer as file:line:col: text for next-error.
+ * Searching is stopped by grep-abort (C-g in the *grep* buffer) or if
+ * the *grep* buffer is killed.
+ * XXX: only literal strings are supported, case is folded for ASCII.
+ */
+#define GREP_MAX_THREADS  16
+#define GREP_QUEUE_SIZE   256
+#define GREP_SLICE_MS     20
+#define GREP_LINE_MAX     256   /* truncate matching lines in output */
+
+typedef struct GrepOutput {
+    char *buf;
+    int len, size;
+} GrepOutput;
+
+typedef struct GrepState {
+    EditBuffer *b;                  /* *grep* buffer */
+    FindFileState *ffst;
+    QETimer *timer;
+    u8 pattern[256];
+    int pattern_len;
+    int ignore_case;
+    int walk_done;
+    volatile sig_atomic_t abort_request;    /* read without the lock */
+    /* the following fields are protected by the mutex */
+    int nb_files, nb_matches;
+    char *queue[GREP_QUEUE_SIZE];   /* files to search */
+    int queue_head, queue_count;
+    GrepOutput results;             /* not yet appended to the buffer */
+#ifdef CONFIG_THREADS
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    pthread_t tid[GREP_MAX_THREADS];
+    int nb_threads;
+    int nb_running;
+#endif
+} GrepState;
+
+static GrepState *grep_state;
+
+static inline void grep_lock(GrepState *gs) {
+#ifdef CONFIG_THREADS
+    pthread_mutex_lock(&gs->mutex);
+#endif
+}
+
+static inline void grep_unlock(GrepState *gs) {
+#ifdef CONFIG_THREADS
+    pthread_mutex_unlock(&gs->mutex);
+#endif
+}
+
+static inline int grep_aborted(GrepState *gs) {
+    return gs->abort_request != 0;
+}
+
+static void grep_output(GrepOutput *out, const void *buf, int len)
+{
+    if (out->len + len > out->size) {
+        int size = max(out->size + (out->size >> 1), out->len + len + 4096);
+        if (!qe_realloc(&out->buf, size))
+            return;
+        out->size = size;
+    }
+    memcpy(out->buf + out->len, buf, len);
+    out->len += len;
+}
+
+static const u8 *grep_find(GrepState *gs, const u8 *p, const u8 *end)
+{
+    const u8 *pat = gs->pattern;
+    int i, len = gs->pattern_len;
+
+    if (!gs->ignore_case) {
+        while (end - p >= len) {
+            p = memchr(p, pat[0], end - p - len + 1);
+            if (!p)
+                return NULL;
+            if (!memcmp(p + 1, pat + 1, len - 1))
+                return p;
+            p++;
+        }
+    } else {
+        /* pattern is stored in lower case */
+        for (; end - p >= len; p++) {
+            if (qe_tolower(*p) == pat[0]) {
+                for (i = 1; i < len && qe_tolower(p[i]) == pat[i]; i++)
+                    continue;
+                if (i == len)
+                    return p;
+            }
+        }
+    }
+    return NULL;
+}
+
+/* Search a file, append the matching lines to 'out'. This function
+ * is called from the worker threads: it must not use the buffer API.
+ * Return the number of matching lines.
+ */
+static int grep_file(GrepState *gs, const char *filename, GrepOutput *out)
+{
+    struct stat st;
+    const u8 *data, *p, *end, *bol, *eol, *q;
+    char header[MAX_FILENAME_SIZE + 32];
+    int fd, size, len, line_num, col, count = 0;
+
+    fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return 0;
+    if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode)
+    ||  st.st_size <= 0 || st.st_size > INT_MAX) {
+        close(fd);
+        return 0;
+    }
+    size = st.st_size;
+#ifdef CONFIG_MMAP
+    data = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return 0;
+#else
+    {
+        u8 *buf = qe_malloc_bytes(size);
+        if (!buf || read(fd, buf, size) != size) {
+            qe_free(&buf);
+            close(fd);
+            return 0;
+        }
+        close(fd);
+        data = buf;
+    }
+#endif
+    end = data + size;
+    /* skip binary files */
+    if (!memchr(data, '\0', min(size, 4096))) {
+        bol = p = data;
+        line_num = 1;
+        while (!grep_aborted(gs) && (p = grep_find(gs, p, end)) != NULL) {
+            /* update line number and beginning of line */
+            while ((q = memchr(bol, '\n', p - bol)) != NULL) {
+                bol = q + 1;
+                line_num++;
+            }
+            /* column is counted in utf-8 characters */
+            for (col = 1, q = bol; q < p; q++)
+                col += !utf8_is_trailing_byte(*q);
+            eol = memchr(p, '\n', end - p);
+            if (!eol)
+                eol = end;
+            len = snprintf(header, sizeof(header), "%s:%d:%d: ",
+                           filename, line_num, col);
+            grep_output(out, header, len);
+            len = eol - bol;
+            if (len > 0 && bol[len - 1] == '\r')
+                len--;
+            grep_output(out, bol, min(len, GREP_LINE_MAX));
+            grep_output(out, "\n", 1);
+            count++;
+            if (eol == end)
+                break;
+            p = bol = eol + 1;
+            line_num++;
+        }
+    }
+#ifdef CONFIG_MMAP
+    munmap((void *)data, size);
+#else
+    qe_free((u8 **)&data);
+#endif
+    return count;
+}
+
+/* Take the next file from the queue: must be called with the lock */
+static char *grep_next_file(GrepState *gs)
+{
+    char *filename = NULL;
+
+    if (gs->queue_count > 0) {
+        filename = gs->queue[gs->queue_head];
+        gs->queue_head = (gs->queue_head + 1) % GREP_QUEUE_SIZE;
+        gs->queue_count--;
+    }
+    return filename;
+}
+
+/* Search a file and publish the results: must be called with the lock */
+static void grep_search_file(GrepState *gs, char *filename)
+{
+    GrepOutput out = { NULL, 0, 0 };
+    int count;
+
+    grep_unlock(gs);
+    count = grep_file(gs, filename, &out);
+    qe_free(&filename);
+    grep_lock(gs);
+    gs->nb_files++;
+    if (count) {
+        gs->nb_matches += count;
+        grep_output(&gs->results, out.buf, out.len);
+    }
+    qe_free(&out.buf);
+}
+
+#ifdef CONFIG_THREADS
+static void *grep_thread(void *opaque)
+{
+    GrepState *gs = opaque;
+    char *filename;
+
+    pthread_mutex_lock(&gs->mutex);
+    for (;;) {
+        if (grep_aborted(gs))
+            break;
+        filename = grep_next_file(gs);
+        if (filename) {
+            grep_search_file(gs, filename);
+        } else {
+            if (gs->walk_done)
+                break;
+            pthread_cond_wait(&gs->cond, &gs->mutex);
+        }
+    }
+    gs->nb_running--;
+    pthread_mutex_unlock(&gs->mutex);
+    return NULL;
+}
+#endif
+
+/* Stop the timer and wait for the worker threads to exit */
+static void grep_halt(GrepState *gs)
+{
+    qe_kill_timer(&gs->timer);
+    grep_lock(gs);
+    gs->abort_request = 1;
+#ifdef CONFIG_THREADS
+    pthread_cond_broadcast(&gs->cond);
+#endif
+    grep_unlock(gs);
+#ifdef CONFIG_THREADS
+    while (gs->nb_threads > 0)
+        pthread_join(gs->tid[--gs->nb_threads], NULL);
+#endif
+}
+
+static void grep_stop(GrepState **gsp)
+{
+    GrepState *gs = *gsp;
+    char *filename;
+
+    if (!gs)
+        return;
+
+    grep_halt(gs);
+#ifdef CONFIG_THREADS
+    pthread_cond_destroy(&gs->cond);
+    pthread_mutex_destroy(&gs->mutex);
+#endif
+    while ((filename = grep_next_file(gs)) != NULL)
+        qe_free(&filename);
+    find_file_close(&gs->ffst);
+    qe_free(&gs->results.buf);
+    qe_free(gsp);
+}
+
+/* Append the results to the *grep* buffer, followed by the final
+ * status if the search is over.
+ */
+static void grep_append(GrepState *gs, GrepOutput *out, const char *status)
+{
+    EditBuffer *b = gs->b;
+    int save_readonly;
+
+    /* Suspend BF_READONLY flag to allow output to readonly buffer */
+    save_readonly = b->flags & BF_READONLY;
+    b->flags &= ~BF_READONLY;
+    if (out->len)
+        eb_write(b, b->total_size, out->buf, out->len);
+    qe_free(&out->buf);
+    if (status) {
+        eb_printf(b, "\nGrep %s: %d matches in %d files\n",
+                  status, gs->nb_matches, gs->nb_files);
+        put_status(NULL, "Grep %s: %d matches in %d files",
+                   status, gs->nb_matches, gs->nb_files);
+    }
+    b->modified = 0;
+    b->flags |= save_readonly;
+}
+
+static void grep_timer_cb(void *opaque)
+{
+    GrepState *gs = opaque;
+    QEmacsState *qs = &qe_state;
+    char filename[MAX_FILENAME_SIZE];
+    int start_time = get_clock_ms();
+    int done, delay, res;
+    GrepOutput out;
+
+    gs->timer = NULL;
+    if (!check_buffer(&gs->b)) {
+        /* results buffer was killed: abort search */
+        grep_stop(&grep_state);
+        return;
+    }
+
+    /* enumerate files by time slice */
+    grep_lock(gs);
+    while (!gs->walk_done && gs->queue_count < GREP_QUEUE_SIZE
+    &&     get_clock_ms() - start_time < GREP_SLICE_MS) {
+        grep_unlock(gs);
+        res = find_file_next(gs->ffst, filename, sizeof(filename));
+        grep_lock(gs);
+        if (res) {
+            gs->walk_done = 1;
+        } else {
+            gs->queue[(gs->queue_head + gs->queue_count) % GREP_QUEUE_SIZE] =
+                qe_strdup(filename);
+            gs->queue_count++;
+        }
+#ifdef CONFIG_THREADS
+        pthread_cond_signal(&gs->cond);
+        if (gs->walk_done)
+            pthread_cond_broadcast(&gs->cond);
+#endif
+    }
+
+#ifndef CONFIG_THREADS
+    /* no threads: search files in the main thread */
+    while (gs->queue_count > 0 && get_clock_ms() - start_time < GREP_SLICE_MS
+    &&     !is_user_input_pending()) {
+        grep_search_file(gs, grep_next_file(gs));
+    }
+    done = gs->walk_done && gs->queue_count == 0;
+#else
+    done = gs->walk_done && gs->nb_running == 0;
+#endif
+    /* poll again soon, immediately if more files can be queued */
+    delay = (!gs->walk_done && gs->queue_count < GREP_QUEUE_SIZE) ? 0 : 10;
+    out = gs->results;
+    gs->results.buf = NULL;
+    gs->results.len = gs->results.size = 0;
+    grep_unlock(gs);
+
+    grep_append(gs, &out, done ? "finished" : NULL);
+
+    if (done) {
+        grep_stop(&grep_state);
+    } else {
+        gs->timer = qe_add_timer(delay, gs, grep_timer_cb);
+    }
+    /* now we do some refresh */
+    edit_display_request(qs);
+}
+
+static void do_grep_abort(EditState *s)
+{
+    GrepState *gs = grep_state;
+    GrepOutput out;
+
+    if (!gs || (s->mode == &pager_mode && s->b != gs->b)) {
+        /* C-g in other pager buffers */
+        do_keyboard_quit(s);
+        return;
+    }
+    /* the workers are stopped, output the matches found so far */
+    grep_halt(gs);
+    if (check_buffer(&gs->b)) {
+        out = gs->results;
+        gs->results.buf = NULL;
+        gs->results.len = gs->results.size = 0;
+        grep_append(gs, &out, "aborted");
+    }
+    grep_stop(&grep_state);
+}
+
+static void do_grep_files(EditState *s, const char *pattern,
+                          const char *file_pattern, const char *dir)
+{
+    char path[MAX_FILENAME_SIZE];
+    GrepState *gs;
+    EditBuffer *b;
+    int i, len, upper_count = 0;
+
+    if (s->flags & (WF_POPUP | WF_MINIBUF))
+        return;
+
+    len = strlen(pattern);
+    if (len == 0 || len >= ssizeof(gs->pattern))
+        return;
+    if (!*file_pattern)
+        file_pattern = "*";
+    canonicalize_absolute_path(s, path, sizeof(path), dir);
+
+    if (s->flags & WF_POPLEFT) {
+        /* avoid messing with the dired pane */
+        s = find_window(s, KEY_RIGHT, s);
+        s->qe_state->active_window = s;
+    }
+
+    /* stop the previous search and kill its buffer */
+    grep_stop(&grep_state);
+    b = eb_find("*grep*");
+    if (b) {
+        qe_kill_buffer(b);
+    }
+
+    gs = qe_mallocz(GrepState);
+    if (!gs)
+        return;
+    memcpy(gs->pattern, pattern, len);
+    gs->pattern_len = len;
+    /* smart case: fold case if search string has no upper case letters */
+    for (i = 0; i < len; i++)
+        upper_count += qe_isupper(gs->pattern[i]);
+    if (!upper_count) {
+        gs->ignore_case = 1;
+        for (i = 0; i < len; i++)
+            gs->pattern[i] = qe_tolower(gs->pattern[i]);
+    }
+    gs->ffst = find_file_open(path, file_pattern,
+                              FF_NOXXDIR | FF_NODIR | FF_DEPTH);
+    b = eb_new("*grep*", BF_UTF8);
+    if (!gs->ffst || !b) {
+        eb_free(&b);
+        find_file_close(&gs->ffst);
+        qe_free(&gs);
+        return;
+    }
+    eb_printf(b, "Grep \"%s\" in files matching %s under %s\n\n",
+              pattern, file_pattern, path);
+    b->modified = 0;
+    b->flags |= BF_READONLY;
+    gs->b = b;
+
+#ifdef CONFIG_THREADS
+    pthread_mutex_init(&gs->mutex, NULL);
+    pthread_cond_init(&gs->cond, NULL);
+    {
+        int n = sysconf(_SC_NPROCESSORS_ONLN);
+        n = clamp(n, 1, GREP_MAX_THREADS);
+        for (i = 0; i < n; i++) {
+            gs->nb_running++;
+            if (pthread_create(&gs->tid[i], NULL, grep_thread, gs)) {
+                gs->nb_running--;
+                break;
+            }
+            gs->nb_threads++;
+        }
+    }
+    if (gs->nb_threads == 0) {
+        put_status(s, "Cannot create grep threads");
+        eb_free(&b);
+        grep_stop(&gs);
+        return;
+    }
+#endif
+    grep_state = gs;
+    gs->timer = qe_add_timer(0, gs, grep_timer_cb);
+
+    /* XXX: try to split window if necessary */
+    switch_to_buffer(s, b);
+    edit_set_mode(s, &pager_mode);
+    set_error_offset(b, 0);
+}
+
 static void do_next_error(EditState *s, int arg, int dir)
 {
     QEmacsState *qs = s->qe_state;
@@ -3348,6 +4139,7 @@ static void do_next_error(EditState *s, int arg, int dir)
 
     if ((b = eb_find(error_buffer)) == NULL) {
         if ((b = eb_find("*compilation*")) == NULL
+        &&  (b = eb_find("*grep*")) == NULL
         &&  (b = eb_find("*shell*")) == NULL
         &&  (b = eb_find("*errors*")) == NULL) {
             put_status(s, "No compilation buffer");
@@ -3634,6 +4426,15 @@ static const CmdDef shell_global_commands[] = {
           "Run make and display a new buffer with its collected output",
           do_compile, ESs,
           "S{make}")
+    CMD2( "grep-files", "",
+          "Search files in a directory tree for a string and list the matching lines",
+          do_grep_files, ESsss,
+          "s{Grep files for: }|search|"
+          "s{In files matching (default *): }|grep-files|"
+          "s{In directory: }[dir]|file|")
+    CMD0( "grep-abort", "",
+          "Stop the running grep-files search, or quit if there is none",
+          do_grep_abort)
     CMD2( "man", "",
           "Run man for a command and display a new buffer with its collected output",
           do_man, ESs,
@@ -3689,6 +4490,7 @@ static const char * const pager_bindings[] = {
     "DEL", "scroll-down",
     "SPC", "scroll-up",
     "/", "search-forward",
+    "C-g", "grep-abort",
     NULL
 };
 
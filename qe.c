@@ -54,6 +54,7 @@ static int generic_mode_init(EditState *s);
 static void generic_mode_close(EditState *s);
 static void generic_text_display(EditState *s);
 static void display1(DisplayState *ds);
+static QERowAnchor *row_anchor_prev(EditState *s, int offset);
 #ifndef CONFIG_TINY
 static void save_selection(void);
 #endif
@@ -621,6 +622,9 @@ void do_set_trace_flags(EditState *s, int flags) {
         if (qs->trace_flags & EB_TRACE_DEBUG) {
             strcat(buf, ", debug");
         }
+        if (qs->trace_flags & EB_TRACE_DISPLAY) {
+            strcat(buf, ", display");
+        }
         put_status(s, "Tracing enabled for %s", buf + 2);
     } else {
         put_status(s, "Tracing disabled");
@@ -672,6 +676,9 @@ void do_set_trace_options(EditState *s, const char *options) {
         } else
         if (strmatchword(p, "debug", &p)) {
             flags |= EB_TRACE_DEBUG;
+        } else
+        if (strmatchword(p, "display", &p)) {
+            flags |= EB_TRACE_DISPLAY;
         } else {
             break;
         }
@@ -1119,6 +1126,9 @@ static int down_cursor_func(DisplayState *ds,
                 m->xdmin = d;
                 m->offsetd = offset1;
             }
+            /* without bidir, the next chars are further right */
+            if (x >= m->xd && !ds->edit_state->bidir)
+                return -1;
         }
         return 0;
     } else if (line_num > m->yd) {
@@ -1328,11 +1338,18 @@ void perform_scroll_up_down(EditState *s, int h)
                    exit loop */
                 s->y_disp = 0;
             } else {
-                int offset = eb_prev(s->b, s->offset_top);
-                s->offset_top = s->mode->backward_offset(s, offset);
-                ds->y = 0;
-                s->mode->display_line(s, ds, s->offset_top);
-                s->y_disp -= ds->y;
+                QERowAnchor *a = row_anchor_prev(s, s->offset_top);
+                if (a) {
+                    /* move back one display row */
+                    s->offset_top = a->offset;
+                    s->y_disp -= a->height;
+                } else {
+                    int offset = eb_prev(s->b, s->offset_top);
+                    s->offset_top = s->mode->backward_offset(s, offset);
+                    ds->y = 0;
+                    s->mode->display_line(s, ds, s->offset_top);
+                    s->y_disp -= ds->y;
+                }
             }
         }
         display_close(ds);
@@ -1434,7 +1451,13 @@ static int left_right_cursor_func(DisplayState *ds,
             m->xdmin = d;
             m->offsetd = offset1;
         }
+        /* without bidir, the next chars are further right */
+        if (m->dir > 0 && !ds->edit_state->bidir)
+            return -1;
         return 0;
+    } else if (line_num == m->yd && m->dir < 0 && !ds->edit_state->bidir) {
+        /* past the cursor: no more chars on its left */
+        return -1;
     } else if (line_num > m->yd) {
         m->after_found = 1;
         /* no need to explore more chars */
@@ -3012,6 +3035,10 @@ void text_mode_line(EditState *s, buf_t *out)
     tag = eb_find_property(s->b, 0, s->offset + 1, QE_PROP_TAG);
     if (tag)
         buf_printf(out, "--%s", (char*)tag->data);
+#ifndef CONFIG_TINY
+    if (s->colorize_cache && s->colorize_cache->colorize_pending)
+        buf_puts(out, "--Fontifying");
+#endif
 #if 0
     buf_printf(out, "--[%d]", s->y_disp);
 #endif
@@ -3385,6 +3412,307 @@ void do_set_system_font(EditState *s, const char *qe_font_name,
     //qs->complete_refresh = 1;
 }
 
+/* Row anchors: each window keeps the offsets and heights of the
+ * display rows laid out around the visible area.  The display can then
+ * start at a row in the middle of a long wrapped line and moving back
+ * one row does not require the layout of the whole text line.
+ */
+#define ROW_ANCHORS_MAX     1024
+/* word wrapping may move a word back to the previous row */
+#define ROW_ANCHORS_MARGIN  (MAX_SCREEN_WIDTH * MAX_CHAR_BYTES)
+
+/* checksum of the window settings that affect the layout of lines */
+static uint64_t display_layout_key(EditState *s, DisplayState *ds)
+{
+    intptr_t key[] = {
+        (intptr_t)s->b, (intptr_t)s->mode, (intptr_t)s->b->charset,
+        (intptr_t)s->prompt, s->b->eol_type, s->b->tab_width,
+        s->qe_state->show_unicode, ds->wrap, ds->width, ds->line_numbers,
+        ds->hex_mode, s->unihex_mode, s->bidir, ds->default_line_height,
+    };
+    uint64_t sum = 0;
+    int i;
+
+    for (i = 0; i < countof(key); i++)
+        sum = (sum << 7) + (sum >> 57) + (uint64_t)key[i];
+    return sum;
+}
+
+/* index of the last anchor at or before `offset`, -1 if none */
+static int row_anchors_find(EditState *s, int offset)
+{
+    int lo = 0, hi = s->nb_row_anchors;
+
+    while (lo < hi) {
+        int mid = (lo + hi) >> 1;
+        if (s->row_anchors[mid].offset <= offset)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo - 1;
+}
+
+/* find the display row containing `offset` */
+static QERowAnchor *row_anchor_lookup(EditState *s, int offset)
+{
+    int i = row_anchors_find(s, offset);
+
+    if (i >= 0 && offset < s->row_anchors[i].next)
+        return &s->row_anchors[i];
+    return NULL;
+}
+
+static void row_anchors_set_next(EditState *s, int offset, int next)
+{
+    int i = row_anchors_find(s, offset);
+
+    if (i >= 0 && s->row_anchors[i].offset == offset)
+        s->row_anchors[i].next = next;
+}
+
+static void row_anchors_add(EditState *s, int offset, int line_start,
+                            int height, int next)
+{
+    QERowAnchor *a;
+    int i, n;
+
+    i = row_anchors_find(s, offset);
+    if (i < 0 || s->row_anchors[i].offset != offset) {
+        if (s->nb_row_anchors >= s->row_anchors_size) {
+            if (s->row_anchors_size >= ROW_ANCHORS_MAX) {
+                /* drop the quarter farthest from the top of the window */
+                a = s->row_anchors;
+                n = s->nb_row_anchors / 4;
+                s->nb_row_anchors -= n;
+                if (s->offset_top - a[0].offset >
+                    a[s->nb_row_anchors + n - 1].offset - s->offset_top) {
+                    memmove(a, a + n, s->nb_row_anchors * sizeof(*a));
+                    i = max(i - n, -1);
+                } else {
+                    i = min(i, s->nb_row_anchors - 1);
+                }
+            } else {
+                n = s->row_anchors_size + 64;
+                if (!qe_realloc(&s->row_anchors, n * sizeof(QERowAnchor)))
+                    return;
+                s->row_anchors_size = n;
+            }
+        }
+        i++;
+        a = &s->row_anchors[i];
+        memmove(a + 1, a, (s->nb_row_anchors - i) * sizeof(*a));
+        s->nb_row_anchors++;
+        a->offset = offset;
+        a->next = -1;
+    }
+    a = &s->row_anchors[i];
+    a->line_start = line_start;
+    a->height = height;
+    if (next >= 0)
+        a->next = next;
+}
+
+/* drop the rows of modified lines, shift the rows of the next ones */
+static void row_anchors_callback(qe__unused__ EditBuffer *b, void *opaque,
+                                 qe__unused__ int arg,
+                                 enum LogOperation op,
+                                 int offset, int size)
+{
+    EditState *s = opaque;
+    QERowAnchor *a;
+    int i, j, end, delta;
+
+    switch (op) {
+    case LOGOP_INSERT:
+        end = offset;
+        delta = size;
+        break;
+    case LOGOP_DELETE:
+        end = offset + size;
+        delta = -size;
+        break;
+    case LOGOP_WRITE:
+        end = offset + size;
+        delta = 0;
+        break;
+    default:
+        s->nb_row_anchors = 0;
+        return;
+    }
+    for (i = j = 0; i < s->nb_row_anchors; i++) {
+        a = &s->row_anchors[i];
+        if (a->line_start > end) {
+            a->offset += delta;
+            a->line_start += delta;
+            if (a->next >= 0)
+                a->next += delta;
+        } else
+        if (a->next < 0 || a->next + ROW_ANCHORS_MARGIN >= offset) {
+            continue;
+        }
+        s->row_anchors[j++] = *a;
+    }
+    s->nb_row_anchors = j;
+}
+
+static void row_anchors_free(EditState *s)
+{
+    qe_free(&s->row_anchors);
+    s->nb_row_anchors = s->row_anchors_size = 0;
+}
+
+/* Column anchors: checkpoints recorded at the start of each chunk of
+ * a long text line.  They hold the char index, the colorizer state and
+ * in truncate mode the horizontal position, so the display can start
+ * near the first visible column and colorize only the chunks it shows.
+ */
+#define COL_ANCHORS_MAX     4096
+
+/* index of the last column anchor at or before `offset`, -1 if none */
+static int col_anchors_find(EditState *s, int offset)
+{
+    int lo = 0, hi = s->nb_col_anchors;
+
+    while (lo < hi) {
+        int mid = (lo + hi) >> 1;
+        if (s->col_anchors[mid].offset <= offset)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo - 1;
+}
+
+/* find the last checkpoint of the line at or before `offset` */
+static QEColAnchor *col_anchor_lookup(EditState *s, int line_start,
+                                      int offset, int line_state)
+{
+    int i = col_anchors_find(s, offset);
+
+    if (i >= 0 && s->col_anchors[i].line_start == line_start
+    &&  s->col_anchors[i].line_state == line_state)
+        return &s->col_anchors[i];
+    return NULL;
+}
+
+/* find the last checkpoint of the line at or before column `x`, not
+   after `offset_max` */
+static QEColAnchor *col_anchor_seek(EditState *s, int line_start, int x,
+                                    int offset_max, int line_state)
+{
+    QEColAnchor *a, *found = NULL;
+    int i;
+
+    for (i = col_anchors_find(s, line_start) + 1; i < s->nb_col_anchors; i++) {
+        a = &s->col_anchors[i];
+        if (a->line_start != line_start || a->x > x || a->offset > offset_max)
+            break;
+        if (a->x >= 0 && a->line_state == line_state)
+            found = a;
+    }
+    return found;
+}
+
+static void col_anchors_add(EditState *s, const QEColAnchor *a1)
+{
+    QEColAnchor *a = s->col_anchors;
+    int i, n;
+
+    i = col_anchors_find(s, a1->offset);
+    if (i < 0 || a[i].offset != a1->offset) {
+        if (s->nb_col_anchors >= s->col_anchors_size) {
+            if (s->col_anchors_size >= COL_ANCHORS_MAX) {
+                /* drop the quarter farthest from the top of the window */
+                n = s->nb_col_anchors / 4;
+                s->nb_col_anchors -= n;
+                if (s->offset_top - a[0].offset >
+                    a[s->nb_col_anchors + n - 1].offset - s->offset_top) {
+                    memmove(a, a + n, s->nb_col_anchors * sizeof(*a));
+                    i = max(i - n, -1);
+                } else {
+                    i = min(i, s->nb_col_anchors - 1);
+                }
+            } else {
+                n = s->col_anchors_size + 64;
+                if (!qe_realloc(&s->col_anchors, n * sizeof(QEColAnchor)))
+                    return;
+                s->col_anchors_size = n;
+                a = s->col_anchors;
+            }
+        }
+        i++;
+        memmove(a + i + 1, a + i, (s->nb_col_anchors - i) * sizeof(*a));
+        s->nb_col_anchors++;
+    }
+    a[i] = *a1;
+}
+
+/* drop the checkpoints after a modification in their line, shift the
+   checkpoints of the next lines */
+static void col_anchors_callback(qe__unused__ EditBuffer *b, void *opaque,
+                                 qe__unused__ int arg,
+                                 enum LogOperation op,
+                                 int offset, int size)
+{
+    EditState *s = opaque;
+    QEColAnchor *a;
+    int i, j, end, delta;
+
+    switch (op) {
+    case LOGOP_INSERT:
+        end = offset;
+        delta = size;
+        break;
+    case LOGOP_DELETE:
+        end = offset + size;
+        delta = -size;
+        break;
+    case LOGOP_WRITE:
+        end = offset + size;
+        delta = 0;
+        break;
+    default:
+        s->nb_col_anchors = 0;
+        return;
+    }
+    for (i = j = 0; i < s->nb_col_anchors; i++) {
+        a = &s->col_anchors[i];
+        if (a->line_start > end) {
+            a->offset += delta;
+            a->line_start += delta;
+        } else
+        if (a->offset >= offset) {
+            continue;
+        }
+        s->col_anchors[j++] = *a;
+    }
+    s->nb_col_anchors = j;
+}
+
+static void col_anchors_free(EditState *s)
+{
+    qe_free(&s->col_anchors);
+    s->nb_col_anchors = s->col_anchors_size = 0;
+}
+
+/* offset of the first char of the pending row, `offset` if empty */
+static int display_pending_offset(DisplayState *ds, int offset)
+{
+    int i;
+
+    for (i = 0; i < ds->line_index; i++) {
+        if (ds->line_offsets[i][0] >= 0 && ds->line_offsets[i][0] < offset)
+            offset = ds->line_offsets[i][0];
+    }
+    for (i = 0; i < ds->fragment_index; i++) {
+        if (ds->fragment_offsets[i][0] >= 0
+        &&  ds->fragment_offsets[i][0] < offset)
+            offset = ds->fragment_offsets[i][0];
+    }
+    return offset;
+}
+
 static void display_bol_bidir(DisplayState *ds, DirType base,
                               int embedding_level_max)
 {
@@ -3467,8 +3795,20 @@ void display_init(DisplayState *ds, EditState *e, enum DisplayType do_disp,
     }
     ds->eol_reached = 0;
     ds->eod = 0;
+    ds->line_start = -1;
+    ds->row_anchors = 0;
+    ds->row_prev = -1;
     display_bol(ds);
     release_font(e->screen, font);
+
+    if (e->mode && e->mode->display_line == text_display_line) {
+        uint64_t key = display_layout_key(e, ds);
+        if (e->row_anchors_key != key) {
+            e->row_anchors_key = key;
+            e->nb_row_anchors = 0;
+            e->nb_col_anchors = 0;
+        }
+    }
 }
 
 static void reverse_fragments(TextFragment *str, int len)
@@ -3523,6 +3863,28 @@ static uint64_t compute_crc(const void *p, int size, uint64_t sum)
     return sum;
 }
 
+/* Display stages are always counted but only timed if requested:
+ * they run many times per frame.
+ */
+static inline int display_stat_timing(EditState *s)
+{
+    QEmacsState *qs = s->qe_state;
+    return qs->display_stats_timing || (qs->trace_flags & EB_TRACE_DISPLAY);
+}
+
+static inline int display_stat_start(EditState *s)
+{
+    return display_stat_timing(s) ? get_clock_usec() : 0;
+}
+
+static inline void display_stat_end(EditState *s, int stage, int start_usec)
+{
+    if (display_stat_timing(s))
+        qe_stat_add(&s->display_stats[stage], start_usec);
+    else
+        s->display_stats[stage].count++;
+}
+
 /* flush the line fragments to the screen.
    `offset1..offset2` is the range of offsets for cursor management
    `last` is 0 for a line wrap, 1 for end of line, -1 for continuation
@@ -3534,6 +3896,7 @@ static void flush_line(DisplayState *ds,
     EditState *e = ds->edit_state;
     QEditScreen *screen = e->screen;
     int level, pos, p, i, x, x1, y, baseline, line_height, max_descent;
+    int start_usec = display_stat_start(e);
     TextFragment *frag;
     QEFont *font;
 
@@ -3743,11 +4106,34 @@ static void flush_line(DisplayState *ds,
            ds->y, ds->line_num, line_height, baseline);
 #endif
     if (last != -1) {
+        if (ds->row_anchors) {
+            /* record the display row */
+            int row_start = -1;
+            for (i = 0; i < nb_fragments; i++) {
+                int j;
+                frag = &fragments[i];
+                for (j = frag->line_index; j < frag->line_index + frag->len; j++) {
+                    int off = ds->line_offsets[j][0];
+                    if (off >= 0 && (row_start < 0 || off < row_start))
+                        row_start = off;
+                }
+            }
+            if (row_start < 0)
+                row_start = offset1;
+            if (row_start >= 0) {
+                row_anchors_add(e, row_start, ds->line_start, line_height,
+                                last == 1 ? offset2 : -1);
+                if (ds->row_prev >= 0)
+                    row_anchors_set_next(e, ds->row_prev, row_start);
+            }
+            ds->row_prev = row_start;
+        }
         /* bump to next line */
         ds->x_line = ds->x_start;
         ds->y += line_height;
         ds->line_num++;
     }
+    display_stat_end(e, QE_STAT_FLUSH_LINE, start_usec);
 }
 
 /* keep 'n' line chars at the start of the line */
@@ -3794,7 +4180,7 @@ static void flush_fragment(DisplayState *ds)
     QEStyleDef styledef;
     QEFont *font;
     unsigned int char_to_glyph_pos[MAX_WORD_SIZE];
-    int nb_glyphs, dst_max_size, ascent, descent;
+    int nb_glyphs, dst_max_size, ascent, descent, start_usec;
 
     if (ds->fragment_index == 0)
         return;
@@ -3820,10 +4206,12 @@ static void flush_fragment(DisplayState *ds)
     //if (dst_max_size <= 0)
     //    goto the_end;
     dst_max_size = MAX_WORD_SIZE; // assuming ds->fragment_index MAX_WORD_SIZE
+    start_usec = display_stat_start(ds->edit_state);
     nb_glyphs = unicode_to_glyphs(ds->line_chars + ds->line_index,
                                   char_to_glyph_pos, dst_max_size,
                                   ds->fragment_chars, ds->fragment_index,
                                   ds->last_embedding_level & 1);
+    display_stat_end(ds->edit_state, QE_STAT_GLYPHS, start_usec);
 
     /* compute new offsets */
     j = ds->line_index;
@@ -4160,8 +4548,14 @@ static void display1(DisplayState *ds)
 /******************************************************/
 int text_backward_offset(EditState *s, int offset)
 {
+    QERowAnchor *a;
     int line, col;
 
+    /* use the line start of a known display row */
+    a = row_anchor_lookup(s, offset);
+    if (a)
+        return a->line_start;
+
     /* CG: beware: offset may fall inside a character */
     eb_get_pos(s->b, &line, &col, offset);
     return eb_goto_pos(s->b, line, 0);
@@ -4214,6 +4608,16 @@ static int bidir_compute_attributes(TypeLink *list_tab, int max_size,
 
     return p - list_tab;
 }
+
+/* bidir_compute_attributes() accounted in the display stats */
+static int display_bidir_attributes(EditState *s, TypeLink *list_tab,
+                                    int max_size, int offset)
+{
+    int start_usec = display_stat_start(s);
+    int res = bidir_compute_attributes(list_tab, max_size, s->b, offset);
+    display_stat_end(s, QE_STAT_BIDIR, start_usec);
+    return res;
+}
 #endif
 
 /************************************************************/
@@ -4237,10 +4641,13 @@ static int get_staticly_colorized_line(EditState *s, unsigned int *buf, int buf_
             /* XXX: set style for end of line? */
             break;
         }
-        if (buf_ptr < buf_end) {
-            sbuf[buf_ptr - buf] = style;
-            *buf_ptr++ = c;
+        if (buf_ptr >= buf_end) {
+            /* line was truncated: skip the rest using the line counts */
+            offset = eb_goto_pos(b, line_num + 1, 0);
+            break;
         }
+        sbuf[buf_ptr - buf] = style;
+        *buf_ptr++ = c;
     }
     *buf_ptr = '\0';
     sbuf[buf_ptr - buf] = 0;  /* end of line style? */
@@ -4248,6 +4655,9 @@ static int get_staticly_colorized_line(EditState *s, unsigned int *buf, int buf_
     return buf_ptr - buf;
 }
 
+/* set while the display colorizes, see syntax_get_colorized_line() */
+static int colorize_display;
+
 #ifndef CONFIG_TINY
 
 /* Gets the colorized line beginning at 'offset'. Its length
@@ -4255,132 +4665,476 @@ static int get_staticly_colorized_line(EditState *s, unsigned int *buf, int buf_
 
 #define COLORIZED_LINE_PREALLOC_SIZE 64
 
-static int syntax_get_colorized_line(EditState *s,
-                                     unsigned int *buf, int buf_size,
-                                     QETermStyle *sbuf,
-                                     int offset, int *offsetp, int line_num)
-{
-    QEColorizeContext cctx;
-    EditBuffer *b = s->b;
-    int i, len, line, n, col, bom;
+#define COLORIZE_SYNC_MS     50   /* bound for the synchronous catch-up */
+#define COLORIZE_BURST_MS    20   /* display calls sharing the bound */
+#define COLORIZE_SLICE_MS    20   /* time slice for idle colorization */
+#define COLORIZE_IDLE_MS    100   /* delay before idle colorization */
 
-    /* invalidate cache if needed */
-    if (s->colorize_max_valid_offset != INT_MAX) {
-        eb_get_pos(b, &line, &col, s->colorize_max_valid_offset);
-        line++;
-        if (line < s->colorize_nb_valid_lines)
-            s->colorize_nb_valid_lines = line;
-        eb_delete_properties(b, s->colorize_max_valid_offset, INT_MAX);
-        s->colorize_max_valid_offset = INT_MAX;
-    }
+static QETimer *colorize_timer;
+static int colorize_sync_start, colorize_sync_last;
 
-    /* realloc state array if needed */
-    if ((line_num + 2) > s->colorize_nb_lines) {
+static void colorize_schedule(int delay);
+
+static int colorize_cache_grow(QEColorizeCache *cc, int nb_lines)
+{
+    int n;
+
+    if (nb_lines > cc->colorize_nb_lines) {
         /* Reallocate colorization state buffer with pseudo-Fibonacci
          * geometric progression (ratio of 1.625)
          */
-        n = max(s->colorize_nb_lines, COLORIZED_LINE_PREALLOC_SIZE);
-        while (n < (line_num + 2))
+        n = max(cc->colorize_nb_lines, COLORIZED_LINE_PREALLOC_SIZE);
+        while (n < nb_lines)
             n += (n >> 1) + (n >> 3);
-        if (!qe_realloc(&s->colorize_states,
-                        n * sizeof(*s->colorize_states))) {
-            return 0;
+        if (!qe_realloc(&cc->colorize_states,
+                        n * sizeof(*cc->colorize_states))) {
+            return -1;
         }
-        s->colorize_nb_lines = n;
+        cc->colorize_nb_lines = n;
+    }
+    return 0;
+}
+
+/* Invalidate the states of the modified lines.  The states after them
+ * are shifted by the number of inserted or deleted lines and kept as
+ * tentative: relexing stops as soon as a recomputed state matches the
+ * cached one.
+ */
+static void colorize_cache_sync(EditBuffer *b, QEColorizeCache *cc)
+{
+    int line_lo, line_hi, nb_lines, delta, col, start, end;
+    int nb_valid = cc->colorize_nb_valid_lines;
+    int sync_line = cc->colorize_sync_line;
+
+    eb_get_pos(b, &line_lo, &col, cc->colorize_max_valid_offset);
+    eb_get_pos(b, &line_hi, &col, min(cc->colorize_dirty_end, b->total_size));
+    eb_get_pos(b, &nb_lines, &col, b->total_size);
+    delta = nb_lines - cc->colorize_buffer_lines;
+    cc->colorize_buffer_lines = nb_lines;
+    cc->colorize_max_valid_offset = INT_MAX;
+
+    /* known states after the modified lines, before the modification */
+    start = line_hi + 1 - delta;
+    if (start < nb_valid) {
+        end = nb_valid;
+        if (sync_line <= nb_valid)
+            end = max(end, cc->colorize_nb_cached_lines);
+    } else {
+        start = max(start, sync_line);
+        end = cc->colorize_nb_cached_lines;
+    }
+    if (end > start && !colorize_cache_grow(cc, end + delta + 1)) {
+        memmove(cc->colorize_states + start + delta,
+                cc->colorize_states + start,
+                (end - start) * sizeof(*cc->colorize_states));
+        cc->colorize_nb_cached_lines = end + delta;
+    } else {
+        cc->colorize_nb_cached_lines = 0;
+    }
+    cc->colorize_sync_line = start + delta;
+    cc->colorize_nb_valid_lines = nb_valid = min(nb_valid, line_lo + 1);
+
+    /* tags of the lines to relex will be recomputed */
+    eb_delete_properties(b, eb_goto_pos(b, max(nb_valid - 1, 0), 0),
+                         eb_goto_pos(b, cc->colorize_sync_line, 0));
+}
+
+/* store the state before `line`: return true if it matches the cached
+   state, the following cached states are then valid again */
+static int colorize_cache_set_state(QEColorizeCache *cc, int line, int state)
+{
+    if (line >= cc->colorize_sync_line && line >= cc->colorize_nb_valid_lines
+    &&  line < cc->colorize_nb_cached_lines
+    &&  cc->colorize_states[line] == state) {
+        cc->colorize_nb_valid_lines = cc->colorize_nb_cached_lines;
+        cc->colorize_sync_line = cc->colorize_nb_cached_lines = 0;
+        return 1;
+    }
+    cc->colorize_states[line] = state;
+    if (cc->colorize_nb_valid_lines < line + 1)
+        cc->colorize_nb_valid_lines = line + 1;
+    return 0;
+}
+
+/* the tags of a line with a tentative state must be recomputed */
+static void colorize_cache_relex(EditBuffer *b, QEColorizeCache *cc,
+                                 int line, int offset, int offset1)
+{
+    if (line >= cc->colorize_sync_line && line < cc->colorize_nb_cached_lines
+    &&  line >= cc->colorize_nb_valid_lines - 1) {
+        eb_delete_properties(b, offset, offset1);
     }
+}
+
+/* Compute the states up to `line_num`, checking every few lines for
+ * the `deadline` if non zero and for user input if `idle`.  Return -1
+ * if interrupted, the states computed so far are kept.
+ */
+static int colorize_cache_propagate(EditState *s, QEColorizeCache *cc,
+                                    unsigned int *buf, int buf_size,
+                                    int line_num, int deadline, int idle)
+{
+    QEColorizeContext cctx;
+    EditBuffer *b = s->b;
+    int len, line, offset, bom, count = 0;
+
+    if (line_num < cc->colorize_nb_valid_lines)
+        return 0;
+
+    /* realloc state array if needed */
+    if (colorize_cache_grow(cc, line_num + 2))
+        return 0;
 
     memset(&cctx, 0, sizeof(cctx));
     cctx.s = s;
     cctx.b = b;
 
-    /* propagate state if needed */
-    if (line_num >= s->colorize_nb_valid_lines) {
-        if (s->colorize_nb_valid_lines == 0) {
-            s->colorize_states[0] = 0; /* initial state : zero */
-            s->colorize_nb_valid_lines = 1;
-        }
-        offset = eb_goto_pos(b, s->colorize_nb_valid_lines - 1, 0);
-        cctx.colorize_state = s->colorize_states[s->colorize_nb_valid_lines - 1];
-        cctx.state_only = 1;
-
-        for (line = s->colorize_nb_valid_lines; line <= line_num; line++) {
-            cctx.offset = offset;
-            len = eb_get_line(b, buf, buf_size - 1, offset, &offset);
-            if (buf[len] != '\n') {
-                /* line was truncated */
-                /* XXX: should use reallocatable buffer */
-                offset = eb_goto_pos(b, line, 0);
-            }
-            buf[len] = '\0';
+    if (cc->colorize_nb_valid_lines == 0) {
+        cc->colorize_states[0] = 0; /* initial state : zero */
+        cc->colorize_nb_valid_lines = 1;
+    }
+    offset = eb_goto_pos(b, cc->colorize_nb_valid_lines - 1, 0);
+    cctx.colorize_state = cc->colorize_states[cc->colorize_nb_valid_lines - 1];
+    cctx.state_only = 1;
+
+    for (line = cc->colorize_nb_valid_lines; line <= line_num; line++) {
+        if (deadline && (count++ & 63) == 0
+        &&  (get_clock_ms() - deadline >= 0
+        ||   (idle && is_user_input_pending()))) {
+            return -1;
+        }
+        cctx.offset = offset;
+        len = eb_get_line(b, buf, buf_size - 1, offset, &offset);
+        if (buf[len] != '\n') {
+            /* line was truncated */
+            /* XXX: should use reallocatable buffer */
+            offset = eb_goto_pos(b, line, 0);
+        }
+        buf[len] = '\0';
+
+        colorize_cache_relex(b, cc, line - 1, cctx.offset, offset);
 
-            /* skip byte order mark if present */
-            bom = (buf[0] == 0xFEFF);
-            if (bom) {
-                cctx.offset = eb_next(b, cctx.offset);
+        /* skip byte order mark if present */
+        bom = (buf[0] == 0xFEFF);
+        if (bom) {
+            cctx.offset = eb_next(b, cctx.offset);
+        }
+        s->colorize_func(&cctx, buf + bom, len - bom, s->colorize_mode);
+        if (colorize_cache_set_state(cc, line, cctx.colorize_state)) {
+            /* the next states are unchanged */
+            if (line_num < cc->colorize_nb_valid_lines)
+                break;
+            line = cc->colorize_nb_valid_lines - 1;
+            offset = eb_goto_pos(b, line, 0);
+            cctx.colorize_state = cc->colorize_states[line];
+        }
+    }
+    return 0;
+}
+
+/* Extend the states of the windows by time slices when idle: first
+ * around the visible area, then up to the end of the buffer.
+ */
+static void colorize_timer_cb(qe__unused__ void *opaque)
+{
+    QEmacsState *qs = &qe_state;
+    unsigned int buf[COLORED_MAX_LINE_SIZE];
+    QEColorizeCache *cc;
+    EditState *s;
+    int deadline, pass, line, col, redisplay = 0;
+
+    colorize_timer = NULL;
+    if (is_user_input_pending()) {
+        colorize_schedule(COLORIZE_IDLE_MS);
+        return;
+    }
+    deadline = get_clock_ms() + COLORIZE_SLICE_MS;
+    for (pass = 0; pass < 2; pass++) {
+        for (s = qs->first_window; s != NULL; s = s->next_window) {
+            cc = s->colorize_cache;
+            if (!cc || !s->colorize_func)
+                continue;
+            if (cc->colorize_max_valid_offset != INT_MAX)
+                colorize_cache_sync(s->b, cc);
+            line = cc->colorize_buffer_lines;
+            if (pass == 0) {
+                /* the visible area and the next page */
+                eb_get_pos(s->b, &line, &col, s->offset_top);
+                line += 2 * s->height /
+                    max(get_line_height(s->screen, s, QE_STYLE_DEFAULT), 1);
+                line = min(line, cc->colorize_buffer_lines);
+            }
+            if (colorize_cache_propagate(s, cc, buf, countof(buf), line,
+                                         deadline, 1) < 0) {
+                colorize_schedule(is_user_input_pending() ?
+                                  COLORIZE_IDLE_MS : 0);
+                goto done;
+            }
+            if (cc->colorize_pending) {
+                cc->colorize_pending = 0;
+                redisplay = 1;
             }
-            s->colorize_func(&cctx, buf + bom, len - bom, s->colorize_mode);
-            s->colorize_states[line] = cctx.colorize_state;
         }
     }
+ done:
+    if (redisplay)
+        edit_display_request(qs);
+}
+
+/* start the idle colorizer if some window states are incomplete */
+static void colorize_schedule(int delay)
+{
+    if (!colorize_timer)
+        colorize_timer = qe_add_timer(delay, NULL, colorize_timer_cb);
+}
+
+/* Colorized lines are cached in a set associative table, keyed by
+ * line offset and colorizer state.  Entries are dropped by
+ * colorize_callback() when the line is modified.
+ */
+#define COLORIZED_LINE_WAYS   4     /* entries per set, LRU eviction */
+#define COLORIZED_LINE_SETS   64    /* power of 2 */
+
+struct QEColorizedLine {
+    int offset;         /* offset of the line, -1 if unused */
+    int offset1;        /* offset of the next line */
+    int state;          /* colorizer state before the line */
+    int state1;         /* colorizer state after the line */
+    int len;            /* number of chars, excluding '\n' */
+    int size;           /* allocated entries in buf and sbuf */
+    unsigned int stamp; /* last use */
+    unsigned int *buf;  /* len + 2 chars */
+    QETermStyle *sbuf;  /* len + 2 styles */
+};
 
-    /* compute line color */
-    cctx.colorize_state = s->colorize_states[line_num];
-    cctx.state_only = 0;
-    cctx.offset = offset;
-    len = eb_get_line(b, buf, buf_size - 1, offset, offsetp);
-    if (buf[len] != '\n') {
-        /* line was truncated */
-        /* XXX: should use reallocatable buffer */
-        *offsetp = eb_next_line(b, offset);
+static QEColorizedLine *colorized_line_set(QEColorizeCache *cc, int offset)
+{
+    unsigned int h = ((unsigned int)offset * 0x9E3779B1U) >> 16;
+    return cc->colorized_lines +
+        (h & (COLORIZED_LINE_SETS - 1)) * COLORIZED_LINE_WAYS;
+}
+
+static QEColorizedLine *colorized_line_find(QEColorizeCache *cc,
+                                            int offset, int state)
+{
+    QEColorizedLine *cl;
+    int i;
+
+    if (!cc->colorized_lines)
+        return NULL;
+    cl = colorized_line_set(cc, offset);
+    for (i = 0; i < COLORIZED_LINE_WAYS; i++, cl++) {
+        if (cl->offset == offset && cl->state == state) {
+            cl->stamp = ++cc->colorized_stamp;
+            return cl;
+        }
     }
-    buf[len] = '\0';
-    if (s->offset >= offset && s->offset < *offsetp + (s->offset == s->b->total_size)) {
-        /* compute cursor position */
-        int offset1 = offset;
-        for (cctx.cur_pos = 0; offset1 < s->offset; cctx.cur_pos++)
-            offset1 = eb_next(b, offset1);
+    return NULL;
+}
+
+static void colorized_line_store(QEColorizeCache *cc, int offset,
+                                 int offset1, int state, int state1,
+                                 const unsigned int *buf,
+                                 const QETermStyle *sbuf, int len)
+{
+    QEColorizedLine *cl, *cl1;
+    int i;
+
+    if (!cc->colorized_lines) {
+        cc->colorized_lines = qe_mallocz_array(QEColorizedLine,
+            COLORIZED_LINE_SETS * COLORIZED_LINE_WAYS);
+        if (!cc->colorized_lines)
+            return;
+        for (i = 0; i < COLORIZED_LINE_SETS * COLORIZED_LINE_WAYS; i++)
+            cc->colorized_lines[i].offset = -1;
+    }
+    /* replace the same line or the least recently used entry */
+    cl = cl1 = colorized_line_set(cc, offset);
+    for (i = 0; i < COLORIZED_LINE_WAYS; i++, cl1++) {
+        if (cl1->offset == offset) {
+            cl = cl1;
+            break;
+        }
+        if (cl1->stamp < cl->stamp)
+            cl = cl1;
+    }
+    cl->offset = -1;
+    cl->stamp = 0;
+    if (len + 2 > cl->size) {
+        if (!qe_realloc(&cl->buf, (len + 2) * sizeof(*cl->buf))
+        ||  !qe_realloc(&cl->sbuf, (len + 2) * sizeof(*cl->sbuf))) {
+            return;
+        }
+        cl->size = len + 2;
     }
+    memcpy(cl->buf, buf, (len + 2) * sizeof(*buf));
+    memcpy(cl->sbuf, sbuf, (len + 2) * sizeof(*sbuf));
+    cl->offset = offset;
+    cl->offset1 = offset1;
+    cl->state = state;
+    cl->state1 = state1;
+    cl->len = len;
+    cl->stamp = ++cc->colorized_stamp;
+}
+
+/* drop the cached lines modified from `offset` */
+static void colorized_lines_invalidate(QEColorizeCache *cc, int offset)
+{
+    QEColorizedLine *cl = cc->colorized_lines;
+    int i;
 
-    bom = (buf[0] == 0xFEFF);
-    if (bom) {
-        SET_COLOR1(buf, 0, QE_STYLE_PREPROCESS);
-        cctx.offset = eb_next(b, cctx.offset);
+    if (!cl)
+        return;
+    for (i = 0; i < COLORIZED_LINE_SETS * COLORIZED_LINE_WAYS; i++, cl++) {
+        /* a line ending at `offset` is modified if it has no newline */
+        if (cl->offset >= 0 && cl->offset1 >= offset) {
+            cl->offset = -1;
+            cl->stamp = 0;
+        }
     }
-    cctx.combine_stop = len - bom;
-    cctx.cur_pos -= bom;
-    s->colorize_func(&cctx, buf + bom, len - bom, s->colorize_mode);
-    cctx.cur_pos += bom;
-    /* buf[len] has char '\0' but may hold style, force buf ending */
-    buf[len + 1] = 0;
+}
 
-    /* XXX: if state is same as previous, minimize invalid region? */
-    s->colorize_states[line_num + 1] = cctx.colorize_state;
+static void colorized_lines_free(QEColorizeCache *cc)
+{
+    int i;
 
-    /* Extend valid area */
-    if (s->colorize_nb_valid_lines < line_num + 2)
-        s->colorize_nb_valid_lines = line_num + 2;
+    if (!cc->colorized_lines)
+        return;
+    for (i = 0; i < COLORIZED_LINE_SETS * COLORIZED_LINE_WAYS; i++) {
+        qe_free(&cc->colorized_lines[i].buf);
+        qe_free(&cc->colorized_lines[i].sbuf);
+    }
+    qe_free(&cc->colorized_lines);
+}
+
+/* position of the cursor in the line, 0 if outside */
+static int colorize_cursor_pos(EditState *s, int offset, int offset1)
+{
+    int pos = 0;
 
-    /* Extract styles from colored codepoint array */
-    for (i = 0; i <= len + 1; i++) {
-        sbuf[i] = buf[i] >> STYLE_SHIFT;
-        buf[i] &= CHAR_MASK;
+    if (s->offset >= offset && s->offset < offset1 + (s->offset == s->b->total_size)) {
+        for (; offset < s->offset; pos++)
+            offset = eb_next(s->b, offset);
     }
+    return pos;
+}
 
-    /* Combine with buffer styles on restricted range */
-    if (s->b->b_styles) {
-        int start = bom + cctx.combine_start, stop = bom + cctx.combine_stop;
-        offset = cctx.offset;
-        for (i = bom; i < stop; i++) {
-            QETermStyle style = eb_get_style(b, offset);
-            if (style && i >= start) {
-                sbuf[i] = style;
+static int syntax_get_colorized_line(EditState *s,
+                                     unsigned int *buf, int buf_size,
+                                     QETermStyle *sbuf,
+                                     int offset, int *offsetp, int line_num)
+{
+    QEColorizeContext cctx;
+    QEColorizeCache *cc = s->colorize_cache;
+    QEColorizedLine *cl;
+    EditBuffer *b = s->b;
+    int i, len, line, bom, state, cur_pos;
+
+    /* invalidate cache if needed */
+    if (cc->colorize_max_valid_offset != INT_MAX)
+        colorize_cache_sync(b, cc);
+
+    /* realloc state array if needed */
+    if (colorize_cache_grow(cc, line_num + 2))
+        return 0;
+
+    /* propagate state if needed */
+    if (line_num >= cc->colorize_nb_valid_lines) {
+        int deadline = 0;
+
+        if (colorize_display) {
+            /* bound the synchronous catch-up: successive display
+               calls share the time budget */
+            int now = get_clock_ms();
+            if (now - colorize_sync_last >= COLORIZE_BURST_MS)
+                colorize_sync_start = now;
+            deadline = colorize_sync_start + COLORIZE_SYNC_MS;
+        }
+        line = colorize_cache_propagate(s, cc, buf, buf_size, line_num,
+                                        deadline, 0);
+        if (colorize_display)
+            colorize_sync_last = get_clock_ms();
+        if (line < 0) {
+            /* display the line without syntax colors, the idle
+               colorizer will catch up and redisplay */
+            cc->colorize_pending = 1;
+            colorize_schedule(0);
+            return -1;
+        }
+    }
+
+    /* reuse the colorized output if the line and its state are unchanged */
+    state = cc->colorize_states[line_num];
+    cl = NULL;
+    if (!b->b_styles)
+        cl = colorized_line_find(cc, offset, state);
+    if (cl && cl->len + 2 <= buf_size) {
+        len = cl->len;
+        memcpy(buf, cl->buf, (len + 2) * sizeof(*buf));
+        memcpy(sbuf, cl->sbuf, (len + 2) * sizeof(*sbuf));
+        *offsetp = cl->offset1;
+        colorize_cache_set_state(cc, line_num + 1, cl->state1);
+        cur_pos = colorize_cursor_pos(s, offset, *offsetp);
+    } else {
+        memset(&cctx, 0, sizeof(cctx));
+        cctx.s = s;
+        cctx.b = b;
+
+        /* compute line color */
+        cctx.colorize_state = state;
+        cctx.state_only = 0;
+        cctx.offset = offset;
+        len = eb_get_line(b, buf, buf_size - 1, offset, offsetp);
+        if (buf[len] != '\n') {
+            /* line was truncated, the display colorizes the rest by chunks */
+            *offsetp = eb_goto_pos(b, line_num + 1, 0);
+        }
+        buf[len] = '\0';
+        colorize_cache_relex(b, cc, line_num, offset, *offsetp);
+        cur_pos = cctx.cur_pos = colorize_cursor_pos(s, offset, *offsetp);
+
+        bom = (buf[0] == 0xFEFF);
+        if (bom) {
+            SET_COLOR1(buf, 0, QE_STYLE_PREPROCESS);
+            cctx.offset = eb_next(b, cctx.offset);
+        }
+        cctx.combine_stop = len - bom;
+        cctx.cur_pos -= bom;
+        s->colorize_func(&cctx, buf + bom, len - bom, s->colorize_mode);
+        /* buf[len] has char '\0' but may hold style, force buf ending */
+        buf[len + 1] = 0;
+
+        /* Extend valid area */
+        colorize_cache_set_state(cc, line_num + 1, cctx.colorize_state);
+
+        /* Extract styles from colored codepoint array */
+        for (i = 0; i <= len + 1; i++) {
+            sbuf[i] = buf[i] >> STYLE_SHIFT;
+            buf[i] &= CHAR_MASK;
+        }
+
+        /* Combine with buffer styles on restricted range */
+        if (s->b->b_styles) {
+            int start = bom + cctx.combine_start, stop = bom + cctx.combine_stop;
+            offset = cctx.offset;
+            for (i = bom; i < stop; i++) {
+                QETermStyle style = eb_get_style(b, offset);
+                if (style && i >= start) {
+                    sbuf[i] = style;
+                }
+                offset = eb_next(b, offset);
             }
-            offset = eb_next(b, offset);
+        } else {
+            colorized_line_store(cc, offset, *offsetp, state,
+                                 cctx.colorize_state, buf, sbuf, len);
         }
     }
+    if (cc->colorize_nb_valid_lines <= cc->colorize_buffer_lines)
+        colorize_schedule(COLORIZE_IDLE_MS);
+
     if (!(s->colorize_mode->flags & MODEF_NO_TRAILING_BLANKS)) {
         /* Mark trailing blanks as errors if cursor is not at end of line */
-        for (i = len; i > 0 && qe_isblank(buf[i - 1]) && i != cctx.cur_pos; i--) {
+        for (i = len; i > 0 && qe_isblank(buf[i - 1]) && i != cur_pos; i--) {
             sbuf[i - 1] = QE_STYLE_BLANK_HILITE;
         }
     }
@@ -4390,14 +5144,79 @@ static int syntax_get_colorized_line(EditState *s,
 /* invalidate the colorize data */
 static void colorize_callback(qe__unused__ EditBuffer *b,
                               void *opaque, qe__unused__ int arg,
-                              qe__unused__ enum LogOperation op,
-                              int offset,
-                              qe__unused__ int size)
+                              enum LogOperation op, int offset, int size)
+{
+    QEColorizeCache *cc = opaque;
+    int end = (op == LOGOP_DELETE) ? offset : offset + size;
+
+    colorized_lines_invalidate(cc, offset);
+    if (cc->colorize_max_valid_offset == INT_MAX) {
+        cc->colorize_max_valid_offset = offset;
+        cc->colorize_dirty_end = end;
+        return;
+    }
+    /* extend the modified span */
+    if (op == LOGOP_INSERT && cc->colorize_dirty_end >= offset) {
+        cc->colorize_dirty_end += size;
+    } else
+    if (op == LOGOP_DELETE && cc->colorize_dirty_end > offset) {
+        cc->colorize_dirty_end = max(offset, cc->colorize_dirty_end - size);
+    }
+    cc->colorize_max_valid_offset = min(cc->colorize_max_valid_offset, offset);
+    cc->colorize_dirty_end = max(cc->colorize_dirty_end, end);
+}
+
+/* get the syntax states shared by the windows colorizing `b` */
+static QEColorizeCache *colorize_cache_get(EditBuffer *b,
+                                           ColorizeFunc colorize_func,
+                                           ModeDef *colorize_mode)
+{
+    QEColorizeCache *cc;
+    int col;
+
+    for (cc = b->colorize_cache_list; cc; cc = cc->next) {
+        if (cc->colorize_func == colorize_func
+        &&  cc->colorize_mode == colorize_mode) {
+            cc->ref_count++;
+            return cc;
+        }
+    }
+    cc = qe_mallocz(QEColorizeCache);
+    if (!cc)
+        return NULL;
+    cc->colorize_func = colorize_func;
+    cc->colorize_mode = colorize_mode;
+    cc->ref_count = 1;
+    cc->colorize_max_valid_offset = INT_MAX;
+    eb_get_pos(b, &cc->colorize_buffer_lines, &col, b->total_size);
+    if (eb_add_callback(b, colorize_callback, cc, 0)) {
+        qe_free(&cc);
+        return NULL;
+    }
+    cc->next = b->colorize_cache_list;
+    b->colorize_cache_list = cc;
+    return cc;
+}
+
+static void colorize_cache_release(EditBuffer *b, QEColorizeCache **ccp)
 {
-    EditState *e = opaque;
+    QEColorizeCache *cc = *ccp, **pp;
 
-    if (offset < e->colorize_max_valid_offset)
-        e->colorize_max_valid_offset = offset;
+    if (!cc)
+        return;
+    *ccp = NULL;
+    if (--cc->ref_count > 0)
+        return;
+    for (pp = &b->colorize_cache_list; *pp; pp = &(*pp)->next) {
+        if (*pp == cc) {
+            *pp = cc->next;
+            break;
+        }
+    }
+    eb_free_callback(b, colorize_callback, cc);
+    colorized_lines_free(cc);
+    qe_free(&cc->colorize_states);
+    qe_free(&cc);
 }
 
 #endif /* CONFIG_TINY */
@@ -4406,76 +5225,251 @@ void set_colorize_func(EditState *s, ColorizeFunc colorize_func, ModeDef *colori
 {
     s->colorize_func = NULL;
 
-#ifndef CONFIG_TINY
-    /* invalidate the previous states & free previous colorizer */
-    eb_free_callback(s->b, colorize_callback, s);
-    qe_free(&s->colorize_states);
-    s->colorize_nb_lines = 0;
-    s->colorize_nb_valid_lines = 0;
-    s->colorize_max_valid_offset = INT_MAX;
-    s->colorize_func = colorize_func;
-    s->colorize_mode = colorize_mode;
-    if (colorize_func)
-        eb_add_callback(s->b, colorize_callback, s, 0);
+#ifndef CONFIG_TINY
+    /* release the previous states & get the shared ones */
+    colorize_cache_release(s->b, &s->colorize_cache);
+    if (colorize_func) {
+        s->colorize_cache = colorize_cache_get(s->b, colorize_func,
+                                               colorize_mode);
+        if (!s->colorize_cache)
+            return;
+    }
+    s->colorize_func = colorize_func;
+    s->colorize_mode = colorize_mode;
+#endif
+}
+
+int get_colorized_line(EditState *s, unsigned int *buf, int buf_size,
+                       QETermStyle *sbuf,
+                       int offset, int *offsetp, int line_num)
+{
+#ifndef CONFIG_TINY
+    if (s->colorize_func) {
+        int len = syntax_get_colorized_line(s, buf, buf_size, sbuf,
+                                            offset, offsetp, line_num);
+        /* states still pending: display the plain line */
+        if (len >= 0)
+            return len;
+    }
+#endif
+    if (s->b->b_styles) {
+        return get_staticly_colorized_line(s, buf, buf_size, sbuf,
+                                           offset, offsetp, line_num);
+    } else {
+        int len = eb_get_line(s->b, buf, buf_size, offset, offsetp);
+        if (buf[len] != '\n') {
+            /* line was truncated */
+            /* XXX: should use reallocatable buffer */
+            *offsetp = eb_goto_pos(s->b, line_num + 1, 0);
+        }
+        buf[len] = '\0';
+        if (sbuf) {
+            memset(sbuf, 0, (len + 1) * sizeof(*sbuf));
+        }
+        // XXX: should test MODEF_NO_TRAILING_BLANKS and mark trailing blanks
+        return len;
+    }
+}
+
+/* colorizer state at the start of line `line_num`, -1 if unknown */
+static int get_colorize_state(EditState *s, int line_num)
+{
+#ifndef CONFIG_TINY
+    QEColorizeCache *cc = s->colorize_cache;
+
+    if (s->colorize_func) {
+        if (!cc || cc->colorize_max_valid_offset != INT_MAX
+        ||  line_num >= cc->colorize_nb_valid_lines)
+            return -1;
+        return cc->colorize_states[line_num];
+    }
+#endif
+    return 0;
+}
+
+/* Get a colorized chunk of a long line, continuing at `offset` with
+   colorizer state `*statep`, which is updated for the next chunk.
+   `*offsetp` is set to the end of the chunk. */
+static int get_colorized_chunk(EditState *s, unsigned int *buf, int buf_size,
+                               QETermStyle *sbuf,
+                               int offset, int *offsetp, int *statep)
+{
+    EditBuffer *b = s->b;
+    int i, len;
+
+#ifndef CONFIG_TINY
+    if (s->colorize_func) {
+        QEColorizeContext cctx;
+
+        memset(&cctx, 0, sizeof(cctx));
+        cctx.s = s;
+        cctx.b = b;
+        cctx.colorize_state = *statep;
+        cctx.offset = offset;
+        len = eb_get_line(b, buf, buf_size - 1, offset, offsetp);
+        buf[len] = '\0';
+        cctx.combine_stop = len;
+        s->colorize_func(&cctx, buf, len, s->colorize_mode);
+        buf[len + 1] = 0;
+        *statep = cctx.colorize_state;
+
+        for (i = 0; i <= len + 1; i++) {
+            sbuf[i] = buf[i] >> STYLE_SHIFT;
+            buf[i] &= CHAR_MASK;
+        }
+        if (b->b_styles) {
+            for (i = 0; i < cctx.combine_stop; i++) {
+                QETermStyle style = eb_get_style(b, offset);
+                if (style && i >= cctx.combine_start) {
+                    sbuf[i] = style;
+                }
+                offset = eb_next(b, offset);
+            }
+        }
+        return len;
+    }
+#endif
+    len = eb_get_line(b, buf, buf_size, offset, offsetp);
+    buf[len] = '\0';
+    for (i = 0; i < len; i++) {
+        sbuf[i] = eb_get_style(b, offset);
+        offset = eb_next(b, offset);
+    }
+    sbuf[len] = 0;
+    return len;
+}
+
+#define RLE_EMBEDDINGS_SIZE    128
+
+/* Apply the window highlights to a colorized chunk of the text line
+   `line_start`..`line_end`, starting at `offset`, char `char_index`
+   of the line. */
+static void display_line_highlights(EditState *s, unsigned int *buf,
+                                    QETermStyle *sbuf, int len,
+                                    int offset, int char_index,
+                                    int line_start, int line_end)
+{
+    int i;
+
+    if (s->mode == &list_mode) {
+        QEmacsState *qs = s->qe_state;
+
+        if ((qs->active_window == s || s->force_highlight) &&
+            s->offset >= line_start && s->offset < line_end)
+        {
+            /* highlight the current line */
+            for (i = 0; i <= len; i++) {
+                sbuf[i] = QE_STYLE_HIGHLIGHT;
+            }
+        } else
+        if (char_index == 0 && buf[0] == '*') {
+            /* selection */
+            for (i = 0; i <= len; i++) {
+                sbuf[i] |= QE_STYLE_SEL;
+            }
+        }
+    }
+    if (s->isearch_state) {
+        isearch_colorize_matches(s, buf, len, sbuf, offset);
+    }
+
+#if 1
+    /* colorize regions */
+    if (s->curline_style || s->region_style) {
+        /* CG: Should combine styles instead of replacing */
+        if (s->region_style && !s->curline_style) {
+            int line, start_offset, end_offset;
+            int start_char, end_char;
+
+            if (s->b->mark < s->offset) {
+                start_offset = max(line_start, s->b->mark);
+                end_offset = min(line_end, s->offset);
+            } else {
+                start_offset = max(line_start, s->offset);
+                end_offset = min(line_end, s->b->mark);
+            }
+            if (start_offset < end_offset && len > 0) {
+                /* Compute character positions */
+                eb_get_pos(s->b, &line, &start_char, start_offset);
+                if (end_offset >= line_end)
+                    end_char = char_index + len;
+                else
+                    eb_get_pos(s->b, &line, &end_char, end_offset);
+                start_char = max(start_char - char_index, 0);
+                end_char = min(end_char - char_index, len);
+
+                for (i = start_char; i < end_char; i++) {
+                    sbuf[i] = s->region_style;
+                }
+            }
+        } else
+        if (s->curline_style && s->offset >= line_start && s->offset <= line_end) {
+            /* XXX: only if qs->active_window == s ? */
+            for (i = 0; i < len; i++)
+                sbuf[i] = s->curline_style;
+        }
+    }
 #endif
 }
 
-int get_colorized_line(EditState *s, unsigned int *buf, int buf_size,
-                       QETermStyle *sbuf,
-                       int offset, int *offsetp, int line_num)
+/* eb_get_pos() accounted in the display stats */
+static int display_get_pos(EditState *s, int *line_ptr, int *col_ptr,
+                           int offset)
 {
-#ifndef CONFIG_TINY
-    if (s->colorize_func) {
-        return syntax_get_colorized_line(s, buf, buf_size, sbuf,
-                                         offset, offsetp, line_num);
-    } else
-#endif
-    if (s->b->b_styles) {
-        return get_staticly_colorized_line(s, buf, buf_size, sbuf,
-                                           offset, offsetp, line_num);
-    } else {
-        int len = eb_get_line(s->b, buf, buf_size, offset, offsetp);
-        if (buf[len] != '\n') {
-            /* line was truncated */
-            /* XXX: should use reallocatable buffer */
-            *offsetp = eb_goto_pos(s->b, line_num + 1, 0);
-        }
-        buf[len] = '\0';
-        if (sbuf) {
-            memset(sbuf, 0, (len + 1) * sizeof(*sbuf));
-        }
-        // XXX: should test MODEF_NO_TRAILING_BLANKS and mark trailing blanks
-        return len;
-    }
+    int start_usec = display_stat_start(s);
+    int res = eb_get_pos(s->b, line_ptr, col_ptr, offset);
+    display_stat_end(s, QE_STAT_GET_POS, start_usec);
+    return res;
 }
 
-#define RLE_EMBEDDINGS_SIZE    128
-
-/* Display one line in the window */
-int text_display_line(EditState *s, DisplayState *ds, int offset)
+static int text_display_line1(EditState *s, DisplayState *ds, int offset)
 {
     int c;
-    int offset0, offset1, line_num, col_num;
+    int offset0, offset1, offset2, line_num, col_num, start_usec;
     TypeLink embeds[RLE_EMBEDDINGS_SIZE], *bd;
     int embedding_level, embedding_max_level;
     FriBidiCharType base;
     unsigned int buf[COLORED_MAX_LINE_SIZE];
     QETermStyle sbuf[COLORED_MAX_LINE_SIZE];
-    int char_index, colored_nb_chars;
+    int char_index, colored_nb_chars, line_start, line_end;
+    int colorize, chunk_offset, chunk_index, chunk_state, line_state;
+    int index_known, x_known, next, eol;
+    QEColAnchor *a1;
+
+    colorize = (s->colorize_func || s->b->b_styles
+             || s->curline_style || s->region_style
+             || s->isearch_state);
 
     line_num = 0;
     /* XXX: should test a flag, to avoid this call in hex/binary */
-    if (s->line_numbers || s->colorize_func) {
-        eb_get_pos(s->b, &line_num, &col_num, offset);
+    if (s->line_numbers || colorize) {
+        display_get_pos(s, &line_num, &col_num, offset);
     }
 
     offset1 = offset;
 
+    /* the display may start at a row in the middle of a wrapped line */
+    line_start = offset;
+    ds->row_anchors = !s->bidir && !(s->flags & WF_MINIBUF);
+    if (offset > 0 && !(s->flags & WF_MINIBUF)
+    &&  eb_prevc(s->b, offset, &offset0) != '\n') {
+        QERowAnchor *a = row_anchor_lookup(s, offset);
+        if (a && a->offset == offset) {
+            line_start = a->line_start;
+        } else {
+            /* not a known row start: do not record the rows */
+            display_get_pos(s, &line_num, &col_num, offset);
+            line_start = eb_goto_pos(s->b, line_num, 0);
+            ds->row_anchors = 0;
+        }
+    }
+    ds->line_start = line_start;
+    ds->row_prev = -1;
+
 #ifdef CONFIG_UNICODE_JOIN
     /* compute the embedding levels and rle encode them */
-    if (s->bidir
-    &&  bidir_compute_attributes(embeds, RLE_EMBEDDINGS_SIZE,
-                                 s->b, offset) > 2)
+    if (s->bidir && eb_line_has_rtl(s->b, offset)
+    &&  display_bidir_attributes(s, embeds, RLE_EMBEDDINGS_SIZE, offset) > 2)
     {
         base = FRIBIDI_TYPE_WL;
         fribidi_analyse_string(embeds, &base, &embedding_max_level);
@@ -4494,11 +5488,36 @@ int text_display_line(EditState *s, DisplayState *ds, int offset)
 
     display_bol_bidir(ds, base, embedding_max_level);
 
+    /* long truncated lines: start at the checkpoint before the first
+       visible column, unless the cursor is skipped */
+    a1 = NULL;
+    line_state = -1;
+    x_known = (ds->wrap == WRAP_TRUNCATE && !s->bidir && !s->prompt
+               && !(s->flags & WF_MINIBUF));
+    if (x_known && line_start == offset && ds->x_disp < 0
+    &&  s->nb_col_anchors > 0
+    &&  (line_state = get_colorize_state(s, line_num)) >= 0) {
+        /* cursor motion needs the char before the cursor */
+        a1 = col_anchor_seek(s, line_start, -ds->x_disp,
+                             s->offset < line_start ? INT_MAX : s->offset - 1,
+                             line_state);
+    }
+    if (a1) {
+        offset = a1->offset;
+        ds->x = ds->x_line = ds->x_disp + a1->x;
+        ds->row_anchors = 0;
+    } else
     /* line numbers */
     if (ds->line_numbers) {
-        ds->style = QE_STYLE_GUTTER;
-        display_printf(ds, -1, -1, "%6d  ", line_num + 1);
-        ds->style = 0;
+        if (line_start == offset) {
+            ds->style = QE_STYLE_GUTTER;
+            display_printf(ds, -1, -1, "%6d  ", line_num + 1);
+            ds->style = 0;
+        } else {
+            /* skip line number column on continuation rows */
+            ds->left_gutter = ds->line_numbers;
+            ds->x = ds->x_line += ds->left_gutter;
+        }
     }
 
     /* prompt display, only on first line */
@@ -4512,76 +5531,64 @@ int text_display_line(EditState *s, DisplayState *ds, int offset)
 
     /* colorize */
     colored_nb_chars = 0;
-    offset0 = offset;
-    if (s->colorize_func || s->b->b_styles
-    ||  s->curline_style || s->region_style
-    ||  s->isearch_state) {
-        /* XXX: deal with truncation */
-        colored_nb_chars = get_colorized_line(s, buf, countof(buf), sbuf,
-                                              offset, &offset0, line_num);
-        if (s->mode == &list_mode) {
-            QEmacsState *qs = s->qe_state;
-            int i;
-
-            if ((qs->active_window == s || s->force_highlight) &&
-                s->offset >= offset && s->offset < offset0)
-            {
-                /* highlight the current line */
-                for (i = 0; i <= colored_nb_chars; i++) {
-                    sbuf[i] = QE_STYLE_HIGHLIGHT;
-                }
-            } else
-            if (buf[0] == '*') {
-                /* selection */
-                for (i = 0; i <= colored_nb_chars; i++) {
-                    sbuf[i] |= QE_STYLE_SEL;
-                }
-            }
-        }
-        if (s->isearch_state) {
-            isearch_colorize_matches(s, buf, colored_nb_chars, sbuf, offset);
-        }
-    }
-
-#if 1
-    /* colorize regions */
-    if (s->curline_style || s->region_style) {
-        /* CG: Should combine styles instead of replacing */
-        if (s->region_style && !s->curline_style) {
-            int line, start_offset, end_offset;
-            int i, start_char, end_char;
-
-            if (s->b->mark < s->offset) {
-                start_offset = max(offset, s->b->mark);
-                end_offset = min(offset0, s->offset);
-            } else {
-                start_offset = max(offset, s->offset);
-                end_offset = min(offset0, s->b->mark);
-            }
-            if (start_offset < end_offset) {
-                /* Compute character positions */
-                eb_get_pos(s->b, &line, &start_char, start_offset);
-                if (end_offset >= offset0)
-                    end_char = colored_nb_chars;
-                else
-                    eb_get_pos(s->b, &line, &end_char, end_offset);
-
-                for (i = start_char; i < end_char; i++) {
-                    sbuf[i] = s->region_style;
-                }
-            }
-        } else
-        if (s->curline_style && s->offset >= offset && s->offset <= offset0) {
-            /* XXX: only if qs->active_window == s ? */
-            int i;
-            for (i = 0; i < colored_nb_chars; i++)
-                sbuf[i] = s->curline_style;
+    line_end = -1;
+    chunk_offset = line_start;
+    chunk_index = 0;
+    chunk_state = -1;
+    if (a1) {
+        char_index = a1->char_index;
+        index_known = 1;
+    } else {
+        /* count the chars of the line before the row, from the last
+           checkpoint if known */
+        char_index = 0;
+        if (offset > line_start && s->nb_col_anchors > 0
+        &&  (line_state = get_colorize_state(s, line_num)) >= 0) {
+            a1 = col_anchor_lookup(s, line_start, offset, line_state);
+        }
+        if (a1) {
+            chunk_offset = a1->offset;
+            chunk_index = char_index = a1->char_index;
+        }
+        for (offset2 = chunk_offset;
+             offset2 < offset && char_index - chunk_index < countof(buf);
+             char_index++) {
+            eb_nextc(s->b, offset2, &offset2);
+        }
+        index_known = (offset2 >= offset);
+        x_known &= (line_start == offset);
+    }
+    if (a1) {
+        chunk_offset = a1->offset;
+        chunk_index = a1->char_index;
+        chunk_state = a1->state;
+    }
+    if (colorize && char_index - chunk_index < countof(buf)) {
+        start_usec = display_stat_start(s);
+        if (chunk_index == 0) {
+            /* XXX: deal with truncation */
+            colorize_display = 1;
+            colored_nb_chars = get_colorized_line(s, buf, countof(buf), sbuf,
+                                                  line_start, &line_end,
+                                                  line_num);
+            colorize_display = 0;
+            /* the state after the first chunk of a long line */
+            line_state = get_colorize_state(s, line_num);
+            chunk_state = get_colorize_state(s, line_num + 1);
+        } else {
+            line_end = eb_goto_pos(s->b, line_num + 1, 0);
+            colored_nb_chars = get_colorized_chunk(s, buf, countof(buf), sbuf,
+                                                   chunk_offset, &offset0,
+                                                   &chunk_state);
         }
+        display_stat_end(s, QE_STAT_COLORIZE, start_usec);
+        display_line_highlights(s, buf, sbuf, colored_nb_chars,
+                                chunk_offset, chunk_index,
+                                line_start, line_end);
     }
-#endif
 
+    next = eol = -1;
     bd = embeds + 1;
-    char_index = 0;
     for (;;) {
         offset0 = offset;
         if (offset >= s->b->total_size) {
@@ -4592,15 +5599,46 @@ int text_display_line(EditState *s, DisplayState *ds, int offset)
             offset = -1; /* signal end of text */
             break;
         } else {
-            ds->style = 0;
-            if (char_index < colored_nb_chars) {
-                ds->style = sbuf[char_index];
-            }
             c = eb_nextc(s->b, offset, &offset);
             if (c == '\n' && !(s->flags & WF_MINIBUF)) {
                 display_eol(ds, offset0, offset);
                 break;
             }
+            if (colored_nb_chars > 0 && chunk_state >= 0
+            &&  char_index - chunk_index == colored_nb_chars
+            &&  !(s->flags & WF_MINIBUF)) {
+                /* continue colorizing a long line by chunks */
+                if (index_known && line_state >= 0 && !s->bidir) {
+                    /* record a checkpoint at the start of the chunk */
+                    QEColAnchor a;
+
+                    a.x = -1;
+                    if (x_known && !qe_isaccent(c)) {
+                        flush_fragment(ds);
+                        a.x = ds->x - ds->x_disp;
+                    }
+                    a.offset = offset0;
+                    a.line_start = line_start;
+                    a.char_index = char_index;
+                    a.state = chunk_state;
+                    a.line_state = line_state;
+                    col_anchors_add(s, &a);
+                }
+                chunk_offset = offset0;
+                chunk_index = char_index;
+                start_usec = display_stat_start(s);
+                colored_nb_chars = get_colorized_chunk(s, buf, countof(buf), sbuf,
+                                                       chunk_offset, &offset2,
+                                                       &chunk_state);
+                display_stat_end(s, QE_STAT_COLORIZE, start_usec);
+                display_line_highlights(s, buf, sbuf, colored_nb_chars,
+                                        chunk_offset, chunk_index,
+                                        line_start, line_end);
+            }
+            ds->style = 0;
+            if (char_index - chunk_index < colored_nb_chars) {
+                ds->style = sbuf[char_index - chunk_index];
+            }
             /* compute embedding from RLE embedding list */
             if (offset0 >= bd[1].pos)
                 bd++;
@@ -4630,19 +5668,334 @@ int text_display_line(EditState *s, DisplayState *ds, int offset)
                 display_char_bidir(ds, offset0, offset, embedding_level, c);
             }
             char_index++;
-            //if (ds->y >= s->height && ds->eod)  //@@@ causes bug
-            //    break;
+            /* early bailout once the rest of the line is not needed */
+            if ((ds->do_disp == DISP_CURSOR && ds->eod)
+            ||  (ds->y >= ds->height &&
+                 (ds->do_disp == DISP_PRINT ||
+                  (ds->do_disp == DISP_CURSOR_SCREEN && ds->eod)))) {
+                /* restart at the pending row */
+                offset = display_pending_offset(ds, offset);
+                if (ds->row_anchors && ds->row_prev >= 0)
+                    row_anchors_set_next(s, ds->row_prev, offset);
+                break;
+            }
+            /* skip the rest of a truncated line beyond the right border */
+            if (ds->wrap == WRAP_TRUNCATE && !s->bidir
+            &&  ds->x >= ds->width + ds->eol_width
+            &&  ds->do_disp != DISP_CURSOR && !(s->flags & WF_MINIBUF)) {
+                if (next < 0) {
+                    int line;
+                    display_get_pos(s, &line, &col_num, offset0);
+                    next = eb_goto_pos(s->b, line + 1, 0);
+                    if (eb_prevc(s->b, next, &eol) != '\n' || next <= offset0)
+                        eol = next;
+                }
+                if (ds->eod || s->offset < offset || s->offset > eol) {
+                    if (eol == next) {
+                        /* last line without a newline */
+                        display_eol(ds, eol, eol + 1);
+                        offset = -1;
+                    } else {
+                        display_eol(ds, eol, next);
+                        offset = next;
+                    }
+                    break;
+                }
+            }
         }
     }
     return offset;
 }
 
+/* Display one line in the window */
+int text_display_line(EditState *s, DisplayState *ds, int offset)
+{
+    int start_usec = display_stat_start(s);
+
+    offset = text_display_line1(s, ds, offset);
+    display_stat_end(s, QE_STAT_LINE, start_usec);
+    return offset;
+}
+
+/* find the display row before the row starting at `offset` */
+static QERowAnchor *row_anchor_prev(EditState *s, int offset)
+{
+    DisplayState ds1, *ds = &ds1;
+    QERowAnchor *a;
+    int prev;
+
+    if (offset <= 0 || s->bidir || s->mode->display_line != text_display_line)
+        return NULL;
+
+    prev = eb_prev(s->b, offset);
+    a = row_anchor_lookup(s, prev);
+    if (!a) {
+        /* lay out the text line to record its rows */
+        display_init(ds, s, DISP_NONE, NULL, NULL);
+        text_display_line(s, ds, text_backward_offset(s, prev));
+        display_close(ds);
+        a = row_anchor_lookup(s, prev);
+    }
+    if (a && a->next == offset)
+        return a;
+    return NULL;
+}
+
+/* Damage tracking to skip the layout of unchanged lines:
+ * each window records the text lines laid out in the last frame,
+ * buffer modifications mark the overlapping lines as damaged and
+ * shift the following ones.  A line is skipped if its text, screen
+ * position and colorizer state are unchanged and its display does
+ * not depend on the cursor or the region.
+ */
+static void display_lines_callback(qe__unused__ EditBuffer *b, void *opaque,
+                                   qe__unused__ int arg,
+                                   enum LogOperation op,
+                                   int offset, int size)
+{
+    EditState *s = opaque;
+    QEDisplayLine *dl;
+    int i, end;
+
+    if (op == LOGOP_FREE) {
+        s->nb_display_lines = 0;
+        return;
+    }
+    for (i = 0; i < s->nb_display_lines; i++) {
+        dl = &s->display_lines[i];
+        end = dl->offset_end < 0 ? INT_MAX : dl->offset_end;
+        switch (op) {
+        case LOGOP_INSERT:
+            if (dl->line_start > offset) {
+                dl->line_start += size;
+                dl->offset += size;
+            } else
+            if (end > offset) {
+                dl->flags |= QDL_DAMAGED;
+            }
+            if (dl->offset_end > offset)
+                dl->offset_end += size;
+            break;
+        case LOGOP_DELETE:
+            if (dl->line_start > offset + size) {
+                dl->line_start -= size;
+                dl->offset -= size;
+            } else
+            if (end > offset) {
+                dl->flags |= QDL_DAMAGED;
+                dl->line_start = min(dl->line_start, offset);
+                if (dl->offset > offset)
+                    dl->offset = offset;
+            }
+            if (dl->offset_end > offset)
+                dl->offset_end = max(offset, dl->offset_end - size);
+            break;
+        case LOGOP_WRITE:
+            if (dl->line_start <= offset + size && end > offset)
+                dl->flags |= QDL_DAMAGED;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+/* checksum of the window settings that affect the display of all lines */
+static uint64_t display_lines_key(EditState *s, DisplayState *ds)
+{
+    QEmacsState *qs = s->qe_state;
+    intptr_t key[] = {
+        (intptr_t)s->b, (intptr_t)s->mode, (intptr_t)s->colorize_func,
+        (intptr_t)s->b->charset, (intptr_t)s->prompt,
+        s->b->eol_type, s->b->tab_width, qs->show_unicode,
+        ds->wrap, ds->width, ds->height, ds->line_numbers, ds->hex_mode,
+        s->unihex_mode, s->bidir, s->x_disp[0], s->x_disp[1],
+        s->region_style, s->curline_style,
+        qs->active_window == s, s->force_highlight,
+    };
+    uint64_t sum = 0;
+    int i;
+
+    for (i = 0; i < countof(key); i++)
+        sum = (sum << 7) + (sum >> 57) + (uint64_t)key[i];
+    return sum;
+}
+
+/* start using the line records for a display pass */
+static void display_lines_start(EditState *s, DisplayState *ds)
+{
+    uint64_t key = display_lines_key(s, ds);
+
+    if (s->display_lines_key != key) {
+        s->display_lines_key = key;
+        s->nb_display_lines = 0;
+    }
+    s->nb_display_lines_next = 0;
+}
+
+/* the line display depends on the cursor or the region */
+static int display_line_is_volatile(EditState *s, int offset, int offset_end)
+{
+    int end = offset_end < 0 ? INT_MAX : offset_end;
+
+    /* cursor, current line and trailing blanks highlighting */
+    if (s->offset >= offset && s->offset <= end)
+        return 1;
+    if (s->region_style) {
+        int start1 = min(s->offset, s->b->mark);
+        int end1 = max(s->offset, s->b->mark);
+        if (start1 <= end && end1 >= offset)
+            return 1;
+    }
+    return 0;
+}
+
+/* get the colorizer state at the start of a line if it is known */
+static int display_line_state(EditState *s, int offset, int line_num,
+                              unsigned short *statep)
+{
+    QEColorizeCache *cc = s->colorize_cache;
+
+    if (cc && cc->colorize_states && line_num < cc->colorize_nb_valid_lines
+    &&  offset <= cc->colorize_max_valid_offset) {
+        *statep = cc->colorize_states[line_num];
+        return 1;
+    }
+    return 0;
+}
+
+static QEDisplayLine *display_find_line(EditState *s, int offset)
+{
+    QEDisplayLine *dl = s->display_lines;
+    int lo = 0, hi = s->nb_display_lines;
+
+    while (lo < hi) {
+        int mid = (lo + hi) >> 1;
+        if (dl[mid].offset < offset)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    for (; lo < s->nb_display_lines && dl[lo].offset == offset; lo++) {
+        if (!(dl[lo].flags & (QDL_DAMAGED | QDL_VOLATILE)))
+            return &dl[lo];
+    }
+    return NULL;
+}
+
+static void display_record_line(EditState *s, const QEDisplayLine *dl)
+{
+    if (s->nb_display_lines_next >= s->display_lines_next_size) {
+        int n = s->display_lines_next_size + LINE_SHADOW_INCR;
+        if (!qe_realloc(&s->display_lines_next, n * sizeof(QEDisplayLine)))
+            return;
+        s->display_lines_next_size = n;
+    }
+    s->display_lines_next[s->nb_display_lines_next++] = *dl;
+}
+
+/* Display the text line at `offset` or skip it if it is unchanged.
+   `*in_sync` tracks whether the colorizer state at `offset` is known
+   to be unchanged. Return the offset of the next line or -1 at end
+   of buffer. */
+static int display_text_line(DisplayState *ds, int offset, int *in_sync)
+{
+    EditState *s = ds->edit_state;
+    QEDisplayLine dl1, *dl;
+    int line_num = 0, col_num, y = ds->y, row = ds->line_num;
+    int need_pos = s->line_numbers || s->colorize_func;
+
+    if (s->mode->display_line != text_display_line
+    ||  s->isearch_state || disable_crc) {
+        return s->mode->display_line(s, ds, offset);
+    }
+
+    dl = display_find_line(s, offset);
+    if (dl && (ds->do_disp != DISP_PRINT ||
+               (dl->y == ds->y && dl->row == ds->line_num))
+    &&  !display_line_is_volatile(s, dl->line_start, dl->offset_end)) {
+        unsigned short state;
+
+        if (need_pos) {
+            eb_get_pos(s->b, &line_num, &col_num, offset);
+            if (s->line_numbers && line_num != dl->text_line)
+                dl = NULL;
+            else
+            if (s->colorize_func && !*in_sync
+            &&  (!display_line_state(s, offset, line_num, &state) ||
+                 state != dl->colorize_state))
+                dl = NULL;
+        }
+        if (dl) {
+            ds->y += dl->height;
+            ds->line_num += dl->nb_rows;
+            *in_sync = 1;
+            if (ds->do_disp == DISP_PRINT) {
+                dl1 = *dl;
+                dl1.text_line = line_num;
+                display_record_line(s, &dl1);
+            }
+            return dl->offset_end;
+        }
+    }
+
+    dl1.offset = offset;
+    dl1.offset_end = s->mode->display_line(s, ds, offset);
+    dl1.line_start = ds->line_start;
+    *in_sync = 0;
+    if (ds->do_disp == DISP_PRINT) {
+        dl1.y = y;
+        dl1.height = ds->y - y;
+        dl1.row = row;
+        dl1.nb_rows = ds->line_num - row;
+        dl1.text_line = 0;
+        dl1.colorize_state = 0;
+        dl1.flags = 0;
+        /* partially displayed lines are not recorded as complete */
+        if (display_line_is_volatile(s, dl1.line_start, dl1.offset_end)
+        ||  ds->y >= ds->height)
+            dl1.flags |= QDL_VOLATILE;
+        if (need_pos) {
+            eb_get_pos(s->b, &dl1.text_line, &col_num, offset);
+            if (s->colorize_func
+            &&  !display_line_state(s, offset, dl1.text_line,
+                                    &dl1.colorize_state)) {
+                dl1.flags |= QDL_VOLATILE;
+            }
+        }
+        display_record_line(s, &dl1);
+    }
+    return dl1.offset_end;
+}
+
+/* make the lines displayed in this frame the reference for the next */
+static void display_lines_end(EditState *s)
+{
+    QEDisplayLine *tmp = s->display_lines;
+    int size = s->display_lines_size;
+
+    s->display_lines = s->display_lines_next;
+    s->display_lines_size = s->display_lines_next_size;
+    s->nb_display_lines = s->nb_display_lines_next;
+    s->display_lines_next = tmp;
+    s->display_lines_next_size = size;
+    s->nb_display_lines_next = 0;
+}
+
+static void display_lines_free(EditState *s)
+{
+    qe_free(&s->display_lines);
+    qe_free(&s->display_lines_next);
+    s->nb_display_lines = s->display_lines_size = 0;
+    s->nb_display_lines_next = s->display_lines_next_size = 0;
+}
+
 /* Generic display algorithm with automatic fit */
 static void generic_text_display(EditState *s)
 {
     CursorContext m1, *m = &m1;
     DisplayState ds1, *ds = &ds1;
-    int x1, xc, yc, offset, bottom = -1;
+    int x1, xc, yc, offset, bottom = -1, in_sync;
 
     if (s->offset == 0) {
         s->offset_top = s->y_disp = s->x_disp[0] = s->x_disp[1] = 0;
@@ -4660,6 +6013,9 @@ static void generic_text_display(EditState *s)
         /* invalidate the line shadow buffer */
         qe_free(&s->line_shadow);
         s->shadow_nb_lines = 0;
+        s->nb_display_lines = 0;
+        s->nb_row_anchors = 0;
+        s->nb_col_anchors = 0;
         s->display_invalid = 0;
     }
 
@@ -4672,13 +6028,15 @@ static void generic_text_display(EditState *s)
     m->offsetc = s->offset;
     m->xc = m->yc = NO_CURSOR;
     display_init(ds, s, DISP_CURSOR_SCREEN, cursor_func, m);
+    display_lines_start(s, ds);
     offset = s->offset_top;
+    in_sync = 0;
     for (;;) {
         if (ds->y <= 0) {
             s->offset_top = offset;
             s->y_disp = ds->y;
         }
-        offset = s->mode->display_line(s, ds, offset);
+        offset = display_text_line(ds, offset, &in_sync);
         s->offset_bottom = offset;
         if (offset < 0 || ds->y >= s->height || m->xc != NO_CURSOR)
             break;
@@ -4689,9 +6047,16 @@ static void generic_text_display(EditState *s)
     if (m->xc == NO_CURSOR) {
         /* if no cursor found then we compute offset_top so that we
            have a chance to find the cursor in a small amount of time */
+        QERowAnchor *a;
+
         display_init(ds, s, DISP_CURSOR_SCREEN, cursor_func, m);
         ds->y = 0;
         offset = s->mode->backward_offset(s, s->offset);
+        if (s->mode->display_line == text_display_line
+        &&  (a = row_anchor_lookup(s, s->offset)) != NULL) {
+            /* start at the display row of the cursor */
+            offset = a->offset;
+        }
         bottom = s->mode->display_line(s, ds, offset);
         if (m->xc == NO_CURSOR) {
             /* XXX: should not happen */
@@ -4700,8 +6065,14 @@ static void generic_text_display(EditState *s)
         } else {
             ds->y = m->yc + m->cursor_height;
         }
+        ds->eod = 0;
 
         while (ds->y < s->height && offset > 0) {
+            if ((a = row_anchor_prev(s, offset)) != NULL) {
+                offset = a->offset;
+                ds->y += a->height;
+                continue;
+            }
             offset = eb_prev(s->b, offset);
             offset = s->mode->backward_offset(s, offset);
             bottom = s->mode->display_line(s, ds, offset);
@@ -4768,12 +6139,32 @@ static void generic_text_display(EditState *s)
         s->x_disp[1] = 0;
     }
 
+    /* skip the display rows above the window */
+    while (s->y_disp < 0) {
+        QERowAnchor *a = row_anchor_lookup(s, s->offset_top);
+        if (!a || a->offset != s->offset_top
+        ||  a->next < 0 || a->next > s->b->total_size
+        ||  s->y_disp + a->height > 0)
+            break;
+        s->offset_top = a->next;
+        s->y_disp += a->height;
+    }
+
     /* now we can display the text and get the real cursor position !  */
 
     m->offsetc = s->offset;
     m->xc = m->yc = NO_CURSOR;
     display_init(ds, s, DISP_PRINT, cursor_func, m);
-    display1(ds);
+    display_lines_start(s, ds);
+    offset = s->offset_top;
+    in_sync = 0;
+    for (;;) {
+        offset = display_text_line(ds, offset, &in_sync);
+        s->offset_bottom = offset;
+        if (offset < 0 || ds->y >= ds->height)
+            break;
+    }
+    display_lines_end(s);
     /* display the remaining region */
     if (ds->y < s->height) {
         QEStyleDef default_style;
@@ -5312,10 +6703,38 @@ void do_execute_command(EditState *s, const char *cmd, int argval)
     }
 }
 
+static void window_display_trace(EditState *s, const QEDisplayStat *stats)
+{
+    char buf[256];
+    buf_t outbuf, *out;
+    int i, usec[QE_STAT_NB];
+
+    for (i = 0; i < QE_STAT_NB; i++)
+        usec[i] = s->display_stats[i].total_usec - stats[i].total_usec;
+    out = buf_init(&outbuf, buf, sizeof(buf));
+    buf_printf(out,
+               "%s: %dus, %d lines %dus, colorize %dus, bidir %dus, "
+               "glyphs %dus, flush_line %dus, get_pos %dus",
+               s->b->name, usec[QE_STAT_WINDOW],
+               s->display_stats[QE_STAT_LINE].count -
+               stats[QE_STAT_LINE].count, usec[QE_STAT_LINE],
+               usec[QE_STAT_COLORIZE], usec[QE_STAT_BIDIR],
+               usec[QE_STAT_GLYPHS], usec[QE_STAT_FLUSH_LINE],
+               usec[QE_STAT_GET_POS]);
+    eb_trace_bytes(buf, -1, EB_TRACE_FLUSH | EB_TRACE_DISPLAY);
+}
+
 void window_display(EditState *s)
 {
     QEmacsState *qs = s->qe_state;
     CSSRect rect;
+    QEDisplayStat stats[QE_STAT_NB];
+    int start_usec = get_clock_usec();
+    int trace = ((qs->trace_flags & EB_TRACE_DISPLAY)
+                 && s->b != qs->trace_buffer);
+
+    if (trace)
+        memcpy(stats, s->display_stats, sizeof(stats));
 
     /* set the clipping rectangle to the whole window */
     /* XXX: should clip out popup windows */
@@ -5334,6 +6753,10 @@ void window_display(EditState *s)
 
     display_mode_line(s);
     display_window_borders(s);
+
+    qe_stat_add(&s->display_stats[QE_STAT_WINDOW], start_usec);
+    if (trace)
+        window_display_trace(s, stats);
 }
 
 /* display all windows */
@@ -5343,6 +6766,7 @@ void edit_display(QEmacsState *qs)
     EditState *s;
     int has_popups, has_minibuf;
     int start_time, elapsed_time;
+    int start_usec = get_clock_usec();
 
     start_time = get_clock_ms();
 
@@ -5401,11 +6825,69 @@ void edit_display(QEmacsState *qs)
         }
     }
 
-    elapsed_time = get_clock_ms() - start_time;
+    qe_stat_add(&qs->display_stat, start_usec);
+    qs->redisplay_time = get_clock_ms();
+    elapsed_time = qs->redisplay_time - start_time;
     if (elapsed_time >= 100)
         put_status(s, "|edit_display: %dms", elapsed_time);
 
     qs->complete_refresh = 0;
+    qs->redisplay_pending = 0;
+}
+
+/* Asynchronous updates (process output, timers) only request a
+ * redisplay: requests are coalesced and the screen is refreshed at
+ * most redisplay_fps times per second.  Keyboard input is processed
+ * first and redisplays synchronously.
+ */
+static QETimer *redisplay_timer;
+
+static int redisplay_delay(QEmacsState *qs)
+{
+    int delay = 0;
+
+    if (qs->redisplay_fps > 0) {
+        delay = 1000 / qs->redisplay_fps -
+            (get_clock_ms() - qs->redisplay_time);
+        if (delay < 0)
+            delay = 0;
+    }
+    return delay;
+}
+
+static void redisplay_timer_cb(void *opaque)
+{
+    QEmacsState *qs = opaque;
+
+    redisplay_timer = NULL;
+    if (!qs->redisplay_pending)
+        return;
+    if (is_user_input_pending()) {
+        /* the pending keys will redisplay */
+        redisplay_timer = qe_add_timer(redisplay_delay(qs) + 1, qs,
+                                       redisplay_timer_cb);
+        return;
+    }
+    edit_display(qs);
+    dpy_flush(qs->screen);
+}
+
+/* return true if a progress update may be flushed to the screen now */
+int edit_display_due(QEmacsState *qs)
+{
+    if (redisplay_delay(qs) > 0)
+        return 0;
+    qs->redisplay_time = get_clock_ms();
+    return 1;
+}
+
+void edit_display_request(QEmacsState *qs)
+{
+    qs->redisplay_pending = 1;
+    if (!redisplay_timer) {
+        redisplay_timer = qe_add_timer(redisplay_delay(qs), qs,
+                                       redisplay_timer_cb);
+    }
 }
 
 /* macros */
@@ -6197,6 +7679,9 @@ void edit_close(EditState **sp)
         qe_free(&s->caption);
         qe_free(&s->line_shadow);
         s->shadow_nb_lines = 0;
+        display_lines_free(s);
+        row_anchors_free(s);
+        col_anchors_free(s);
         qe_free(sp);
     }
 }
@@ -8932,6 +10417,44 @@ void unget_key(int key)
     qs->ungot_key = key;
 }
 
+/* Insert a block of pasted text with a single insertion and undo
+ * record.  Fall back to processing the text as keys if a key sequence
+ * or a grab is in progress, or if the mode handles characters itself.
+ */
+static void qe_paste_text(const char *text, int len)
+{
+    QEmacsState *qs = &qe_state;
+    QEKeyContext *c = &key_ctx;
+    EditState *s = qs->active_window;
+    EditBuffer *b1;
+    const char *p, *end;
+
+    if (s && !c->grab_key_cb && c->nb_keys == 0 && !qs->defining_macro
+    &&  s->mode->write_char == text_write_char
+    &&  !s->overwrite && !s->input_method
+    &&  !(s->b->flags & (BF_READONLY | BF_PREVIEW))
+    &&  (b1 = eb_new("*paste*", BF_SYSTEM)) != NULL) {
+        eb_set_charset(b1, &charset_utf8, EOL_UNIX);
+        eb_insert(b1, 0, text, len);
+        do_delete_selection(s);
+        s->region_style = 0;
+        s->b->mark = s->offset;
+        s->b->last_log = LOGOP_FREE;
+        s->offset += eb_insert_buffer_convert(s->b, s->offset,
+                                              b1, 0, b1->total_size);
+        /* do not merge the next insertions into the same undo record */
+        s->b->last_log = LOGOP_FREE;
+        eb_free(&b1);
+        edit_display(qs);
+        dpy_flush(qs->screen);
+        return;
+    }
+    for (p = text, end = text + len; p < end;) {
+        int key = utf8_decode(&p);
+        qe_key_process(key == '\n' ? KEY_RET : key);
+    }
+}
+
 /* handle an event sent by the GUI */
 void qe_handle_event(QEEvent *ev)
 {
@@ -8949,6 +10472,12 @@ void qe_handle_event(QEEvent *ev)
         }
         qe_key_process(ev->key_event.key);
         break;
+    case QE_PASTE_EVENT:
+        if (qs->trace_buffer)
+            eb_trace_bytes(ev->paste_event.text, ev->paste_event.len,
+                           EB_TRACE_KEY);
+        qe_paste_text(ev->paste_event.text, ev->paste_event.len);
+        break;
     case QE_EXPOSE_EVENT:
         do_refresh(qs->first_window);
         goto redraw;
@@ -9020,6 +10549,9 @@ static int generic_mode_init(EditState *s)
     // XXX: should track insertions at s->offset?
     eb_add_callback(s->b, eb_offset_callback, &s->offset, 0);
     eb_add_callback(s->b, eb_offset_callback, &s->offset_top, 0);
+    eb_add_callback(s->b, display_lines_callback, s, 0);
+    eb_add_callback(s->b, row_anchors_callback, s, 0);
+    eb_add_callback(s->b, col_anchors_callback, s, 0);
     set_colorize_func(s, NULL, NULL);
     return 0;
 }
@@ -9050,10 +10582,16 @@ static void generic_mode_close(EditState *s)
     set_colorize_func(s, NULL, NULL);
     eb_free_callback(s->b, eb_offset_callback, &s->offset);
     eb_free_callback(s->b, eb_offset_callback, &s->offset_top);
+    eb_free_callback(s->b, display_lines_callback, s);
+    eb_free_callback(s->b, row_anchors_callback, s);
+    eb_free_callback(s->b, col_anchors_callback, s);
 
     /* Free crcs should when switching display modes */
     qe_free(&s->line_shadow);
     s->shadow_nb_lines = 0;
+    display_lines_free(s);
+    row_anchors_free(s);
+    col_anchors_free(s);
 }
 
 ModeDef text_mode = {
@@ -9493,6 +11031,10 @@ static void qe_init(void *opaque)
     qs->default_fill_column = DEFAULT_FILL_COLUMN;
     qs->mmap_threshold = MIN_MMAP_SIZE;
     qs->max_load_size = MAX_LOAD_SIZE;
+    qs->redisplay_fps = DEFAULT_REDISPLAY_FPS;
+    qs->tty_low_bandwidth = DEFAULT_TTY_LOW_BANDWIDTH;
+    qs->shell_scrollback_lines = DEFAULT_SHELL_SCROLLBACK_LINES;
+    qs->shell_scrollback_size = DEFAULT_SHELL_SCROLLBACK_SIZE;
 
     /* setup resource path */
     set_user_option(NULL);
@@ -50,6 +50,18 @@
 #ifndef DEFAULT_FILL_COLUMN
 #define DEFAULT_FILL_COLUMN  70
 #endif
+#ifndef DEFAULT_REDISPLAY_FPS
+#define DEFAULT_REDISPLAY_FPS  30
+#endif
+#ifndef DEFAULT_TTY_LOW_BANDWIDTH
+#define DEFAULT_TTY_LOW_BANDWIDTH  4800
+#endif
+#ifndef DEFAULT_SHELL_SCROLLBACK_LINES
+#define DEFAULT_SHELL_SCROLLBACK_LINES  0
+#endif
+#ifndef DEFAULT_SHELL_SCROLLBACK_SIZE
+#define DEFAULT_SHELL_SCROLLBACK_SIZE  (64 << 20)
+#endif
 
 /* OS specific defines */
 
@@ -875,6 +887,7 @@ enum QEEventType {
     QE_BUTTON_RELEASE_EVENT, /* mouse button release event */
     QE_MOTION_EVENT, /* mouse motion event */
     QE_SELECTION_CLEAR_EVENT, /* request selection clear (X11 type selection) */
+    QE_PASTE_EVENT, /* block of text pasted in the terminal */
 };
 
 #define KEY_CTRL(c)     ((c) & 0x001f)
@@ -986,12 +999,19 @@ typedef struct QEMotionEvent {
     int y;
 } QEMotionEvent;
 
+typedef struct QEPasteEvent {
+    enum QEEventType type;
+    const char *text;   /* UTF-8 encoded, newlines as '\n' */
+    int len;
+} QEPasteEvent;
+
 typedef union QEEvent {
     enum QEEventType type;
     QEKeyEvent key_event;
     QEExposeEvent expose_event;
     QEButtonEvent button_event;
     QEMotionEvent motion_event;
+    QEPasteEvent paste_event;
 } QEEvent;
 
 void qe_handle_event(QEEvent *ev);
@@ -1031,6 +1051,34 @@ struct QEColorizeContext {
 typedef void (*ColorizeFunc)(QEColorizeContext *cp,
                              unsigned int *buf, int n, ModeDef *syn);
 
+/* syntax states of a buffer shared by the windows using the same
+ * colorizer, reference counted and linked from the buffer.
+ */
+typedef struct QEColorizeCache QEColorizeCache;
+typedef struct QEColorizedLine QEColorizedLine;
+struct QEColorizeCache {
+    QEColorizeCache *next;
+    ColorizeFunc colorize_func;
+    ModeDef *colorize_mode;
+    int ref_count;
+    unsigned short *colorize_states; /* state before line n, one per line */
+    int colorize_nb_lines;
+    int colorize_nb_valid_lines;
+    /* maximum valid offset, INT_MAX if not modified. Needed to
+     * invalidate 'colorize_states' */
+    int colorize_max_valid_offset;
+    int colorize_dirty_end;     /* end of the modified span */
+    int colorize_buffer_lines;  /* number of buffer lines when synced */
+    /* states kept after the last modified lines: they become valid
+       again once a recomputed state matches, see colorize_cache_sync() */
+    int colorize_sync_line;
+    int colorize_nb_cached_lines;
+    int colorize_pending;       /* display waits for the idle colorizer */
+    /* colorized output of recently displayed lines */
+    QEColorizedLine *colorized_lines;
+    unsigned int colorized_stamp;
+};
+
 /* buffer.c */
 
 /* begin to mmap files from this size */
@@ -1046,6 +1094,8 @@ typedef void (*ColorizeFunc)(QEColorizeContext *cp,
 #define PG_VALID_POS    0x0002 /* set if the nb_lines / col fields are up to date */
 #define PG_VALID_CHAR   0x0004 /* nb_chars is valid */
 #define PG_VALID_COLORS 0x0008 /* color state is valid (unused) */
+#define PG_VALID_RTL    0x0010 /* PG_HAS_RTL is up to date */
+#define PG_HAS_RTL      0x0020 /* the page may contain right to left text */
 
 typedef struct Page {   /* should pack this */
     int size;     /* data size */
@@ -1135,13 +1185,7 @@ struct EditBuffer {
 
     /* buffer syntax or major mode */
     ModeDef *syntax_mode;
-    ColorizeFunc colorize_func; /* line colorization function */
-    unsigned short *colorize_states; /* state before line n, one per line */
-    int colorize_nb_lines;
-    int colorize_nb_valid_lines;
-    /* maximum valid offset, INT_MAX if not modified. Needed to
-     * invalidate 'colorize_states' */
-    int colorize_max_valid_offset;
+    QEColorizeCache *colorize_cache_list; /* syntax states per colorizer */
 
     /* charset handling */
     CharsetDecodeState charset_state;
@@ -1207,7 +1251,8 @@ struct EditBuffer {
 /* the log buffer is used for the undo operation */
 /* header of log operation */
 typedef struct LogBuffer {
-    u8 pad1, pad2;    /* for Log buffer readability */
+    u8 pad1, pad2;    /* for Log buffer readability, pad2 is '+' for
+                         records chained to the previous one */
     u8 op;
     u8 was_modified;
     int offset;
@@ -1225,7 +1270,9 @@ int eb_insert_buffer(EditBuffer *dest, int dest_offset,
                      int size);
 int eb_insert(EditBuffer *b, int offset, const void *buf, int size);
 int eb_delete(EditBuffer *b, int offset, int size);
+int eb_trim_head(EditBuffer *b, int size);
 int eb_replace(EditBuffer *b, int offset, int size, const void *buf, int size1);
+int eb_replace_buffer(EditBuffer *b, int offset, int size, EditBuffer *src);
 void eb_free_log_buffer(EditBuffer *b);
 EditBuffer *eb_new(const char *name, int flags);
 EditBuffer *eb_scratch(const char *name, int flags);
@@ -1252,6 +1299,7 @@ int eb_delete_chars(EditBuffer *b, int offset, int n);
 int eb_delete_glyphs(EditBuffer *b, int offset, int n);
 int eb_goto_pos(EditBuffer *b, int line1, int col1);
 int eb_get_pos(EditBuffer *b, int *line_ptr, int *col_ptr, int offset);
+int eb_line_has_rtl(EditBuffer *b, int offset);
 int eb_goto_char(EditBuffer *b, int pos);
 int eb_get_char_offset(EditBuffer *b, int offset);
 int eb_delete_range(EditBuffer *b, int p1, int p2);
@@ -1396,6 +1444,51 @@ typedef struct QELineShadow {
     short height;
 } QELineShadow;
 
+/* text line laid out in the last frame, used to skip unchanged lines */
+typedef struct QEDisplayLine {
+    int offset;         /* offset of the start of the first row */
+    int offset_end;     /* offset of the next line, -1 at end of buffer */
+    int line_start;     /* offset of the start of the text line */
+    int text_line;      /* line number in the buffer */
+    short y, height;    /* position and height of the display rows */
+    short row, nb_rows; /* index of the first display row and count */
+    unsigned short colorize_state;  /* colorizer state at line start */
+    unsigned short flags;
+#define QDL_DAMAGED   0x01  /* text modified since the last frame */
+#define QDL_VOLATILE  0x02  /* display depends on cursor or region */
+} QEDisplayLine;
+
+/* display row of a text line, used to restart the display mid-line */
+typedef struct QERowAnchor {
+    int offset;         /* offset of the first char of the row */
+    int next;           /* offset of the next row, -1 if unknown */
+    int line_start;     /* offset of the start of the text line */
+    int height;         /* row height */
+} QERowAnchor;
+
+/* display profiling stages, per window */
+enum {
+    QE_STAT_WINDOW,         /* window_display */
+    QE_STAT_LINE,           /* text_display_line */
+    QE_STAT_COLORIZE,       /* colorizer and colorized line cache */
+    QE_STAT_BIDIR,          /* bidir_compute_attributes */
+    QE_STAT_GLYPHS,         /* unicode_to_glyphs */
+    QE_STAT_FLUSH_LINE,     /* flush_line */
+    QE_STAT_GET_POS,        /* eb_get_pos */
+    QE_STAT_NB,
+};
+
+/* checkpoint in a long text line, where the display restarts the
+   colorizer on a new chunk of the line */
+typedef struct QEColAnchor {
+    int offset;         /* offset of the char */
+    int line_start;     /* offset of the start of the text line */
+    int char_index;     /* index of the char in the line */
+    int x;              /* position from the line start, -1 if wrapped */
+    int state;          /* colorizer state before the char */
+    int line_state;     /* colorizer state at the start of the line */
+} QEColAnchor;
+
 enum WrapType {
     WRAP_AUTO = 0,
     WRAP_TRUNCATE,
@@ -1455,14 +1548,8 @@ struct EditState {
     ModeDef *mode;
     OWNED QEModeData *mode_data; /* mode private window based data */
 
-    /* state before line n, one short per line */
-    /* XXX: move this to buffer based mode_data */
-    unsigned short *colorize_states;
-    int colorize_nb_lines;
-    int colorize_nb_valid_lines;
-    /* maximum valid offset, INT_MAX if not modified. Needed to invalide
-       'colorize_states' */
-    int colorize_max_valid_offset;
+    /* syntax states shared with the other windows on the buffer */
+    QEColorizeCache *colorize_cache;
 
     int busy; /* true if editing cannot be done if the window
                  (e.g. the parser HTML is parsing the buffer to
@@ -1503,6 +1590,21 @@ struct EditState {
     char modeline_shadow[MAX_SCREEN_WIDTH];
     OWNED QELineShadow *line_shadow; /* per window shadow CRC data */
     int shadow_nb_lines;
+    /* text lines of the last frame and of the frame being displayed */
+    OWNED QEDisplayLine *display_lines;
+    OWNED QEDisplayLine *display_lines_next;
+    int nb_display_lines, display_lines_size;
+    int nb_display_lines_next, display_lines_next_size;
+    uint64_t display_lines_key; /* checksum of the window display settings */
+    /* display rows around the visible area */
+    OWNED QERowAnchor *row_anchors;
+    int nb_row_anchors, row_anchors_size;
+    uint64_t row_anchors_key;   /* checksum of the window layout settings */
+    /* checkpoints in long lines */
+    OWNED QEColAnchor *col_anchors;
+    int nb_col_anchors, col_anchors_size;
+    /* display profiling, see describe-display-stats */
+    QEDisplayStat display_stats[QE_STAT_NB];
     /* compose state for input method */
     InputMethod *input_method; /* current input method */
     InputMethod *selected_input_method; /* selected input method (used to switch) */
@@ -1699,6 +1801,7 @@ struct QEmacsState {
 #define EB_TRACE_PTY      0x10
 #define EB_TRACE_EMULATE  0x20
 #define EB_TRACE_DEBUG    0x30
+#define EB_TRACE_DISPLAY  0x40
 #define EB_TRACE_ALL      0x7F
 #define EB_TRACE_FLUSH    0x100
 
@@ -1714,6 +1817,15 @@ struct QEmacsState {
     int hide_status; /* true if status should be hidden */
     int complete_refresh;
     int is_full_screen;
+    QEDisplayStat display_stat; /* edit_display frames */
+    int display_stats_timing;   /* time the display stages of windows */
+    /* coalesced redisplay of asynchronous updates */
+    int redisplay_fps;      /* maximum screen updates per second */
+    int redisplay_pending;
+    int redisplay_time;     /* time of the last edit_display */
+    int tty_low_bandwidth;  /* tty throughput (bytes/s) for cheap rendering */
+    int shell_scrollback_lines; /* maximum lines of process output buffers */
+    int shell_scrollback_size;  /* maximum size of process output buffers */
     /* select display aspect for non-latin1 characters:
      * 0 (auto) -> display as unicode on utf-8 capable ttys and x11
      * 1 (nc) -> display as ? or ?? non character symbols
@@ -1757,6 +1869,8 @@ struct QEmacsState {
     int hilite_region;  /* hilite the current region when selecting */
     int mmap_threshold; /* minimum file size for mmap */
     int max_load_size;  /* maximum file size for loading in memory */
+    int search_index_save;  /* save search indexes alongside mmapped files */
+    int search_accent_fold; /* ignore accents in searches by default */
     int default_tab_width;      /* DEFAULT_TAB_WIDTH */
     int default_fill_column;    /* DEFAULT_FILL_COLUMN */
     EOLType default_eol_type;  /* EOL_UNIX */
@@ -1951,6 +2065,9 @@ struct DisplayState {
     int eol_reached;
     EditState *edit_state;
     QETermStyle style;   /* current style for display_printf... */
+    int line_start;     /* start of the text line or -1 */
+    int row_anchors;    /* record the display rows of the line */
+    int row_prev;       /* offset of the previous row of the line or -1 */
 
 #if 0
     QEFont *font;
@@ -2161,6 +2278,8 @@ void do_create_window(EditState *s, const char *filename, const char *layout);
 void qe_save_window_layout(EditState *s, EditBuffer *b);
 
 void edit_display(QEmacsState *qs);
+void edit_display_request(QEmacsState *qs);
+int edit_display_due(QEmacsState *qs);
 void edit_invalidate(EditState *s, int all);
 void display_mode_line(EditState *s);
 int edit_set_mode(EditState *s, ModeDef *m);
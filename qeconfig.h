@@ -388,7 +388,7 @@ static const CmdDef basic_commands[] = {
           "Enable or disable trace mode: show the *Trace* buffer with debugging info",
           do_toggle_trace_mode, ESi, "P")
     CMD2( "set-trace-options", "C-h t",
-         "Select the trace options: all, none, command, debug, emulate, shell, tty, pty",
+         "Select the trace options: all, none, command, debug, display, emulate, shell, tty, pty",
           do_set_trace_options, ESs,
           "s{Trace options: }|trace|")
     CMD0( "describe-key-briefly", "C-h c, C-h k, f6",
@@ -22,6 +22,9 @@
 #include "qe.h"
 #include "variables.h"
 
+/* case folding and accent stripping tables are produced by unifold.c */
+#include "unicode_fold.h"
+
 /* Search stuff */
 
 #define SEARCH_FLAG_IGNORECASE 0x0001
@@ -31,6 +34,7 @@
 #define SEARCH_FLAG_HEX        0x0010
 #define SEARCH_FLAG_UNIHEX     0x0020
 #define SEARCH_FLAG_REGEX      0x0040
+#define SEARCH_FLAG_IGNOREACCENT 0x0080  /* ignore diacritics */
 #define SEARCH_FLAG_ACTIVE     0x1000
 
 /* should separate search string length and number of match positions */
@@ -65,14 +69,61 @@ static unsigned int last_search_u32[SEARCH_LENGTH];
 static int last_search_u32_len = 0;
 static int last_search_u32_flags = 0;
 
-static int eb_search(EditBuffer *b, int dir, int flags,
-                     int start_offset, int end_offset,
-                     const unsigned int *buf, int len,
-                     CSSAbortFunc *abort_func, void *abort_opaque,
-                     int *found_offset, int *found_end)
+/* Fold a character for case and/or accent insensitive comparisons:
+ * diacritics fold to 0.
+ */
+static inline unsigned int search_fold_char(unsigned int c, int flags)
+{
+    if (c < UNICODE_FOLD_LIMIT) {
+        if (flags & SEARCH_FLAG_IGNOREACCENT) {
+            c += unicode_fold_accent[unicode_fold_accent_index[c >> UNICODE_FOLD_SHIFT]]
+                [c & ((1 << UNICODE_FOLD_SHIFT) - 1)];
+        }
+        if (flags & SEARCH_FLAG_IGNORECASE) {
+            c += unicode_fold_case[unicode_fold_case_index[c >> UNICODE_FOLD_SHIFT]]
+                [c & ((1 << UNICODE_FOLD_SHIFT) - 1)];
+        }
+    }
+    return c;
+}
+
+static int search_default_flags(void)
+{
+    int flags = SEARCH_FLAG_SMARTCASE;
+
+    if (qe_state.search_accent_fold)
+        flags |= SEARCH_FLAG_IGNOREACCENT;
+    return flags;
+}
+
+/* analyze search string if smart case */
+static int search_smartcase_flags(int flags, const unsigned int *buf, int len)
 {
+    if (flags & SEARCH_FLAG_SMARTCASE) {
+        int upper_count = 0;
+        int pos;
+        for (pos = 0; pos < len; pos++) {
+            /* upper and title case letters fold to a different letter */
+            upper_count += (search_fold_char(buf[pos],
+                                             SEARCH_FLAG_IGNORECASE) != buf[pos]);
+        }
+        if (upper_count == 0)
+            flags |= SEARCH_FLAG_IGNORECASE;
+    }
+    return flags;
+}
+
+/* Scan the buffer for a match starting before 'end_offset' */
+static int eb_search1(EditBuffer *b, int dir, int flags,
+                      int start_offset, int end_offset,
+                      const unsigned int *buf, int len,
+                      CSSAbortFunc *abort_func, void *abort_opaque,
+                      int *found_offset, int *found_end)
+{
+    unsigned int fold_buf[SEARCH_LENGTH];
     int total_size = b->total_size;
     int c, c2, offset = start_offset, offset1, offset2, offset3, pos;
+    int fold, len1;
 
     if (len == 0)
         return 0;
@@ -83,17 +134,7 @@ static int eb_search(EditBuffer *b, int dir, int flags,
     *found_offset = -1;
     *found_end = -1;
 
-    /* analyze buffer if smart case */
-    if (flags & SEARCH_FLAG_SMARTCASE) {
-        int upper_count = 0;
-        int lower_count = 0;
-        for (pos = 0; pos < len; pos++) {
-            lower_count += qe_islower(buf[pos]);
-            upper_count += qe_isupper(buf[pos]);
-        }
-        if (lower_count > 0 && upper_count == 0)
-            flags |= SEARCH_FLAG_IGNORECASE;
-    }
+    flags = search_smartcase_flags(flags, buf, len);
 
     if (flags & SEARCH_FLAG_HEX) {
         /* handle buffer as single bytes */
@@ -134,6 +175,20 @@ static int eb_search(EditBuffer *b, int dir, int flags,
         }
     }
 
+    /* fold the search string once, dropping diacritics */
+    fold = flags & (SEARCH_FLAG_IGNORECASE | SEARCH_FLAG_IGNOREACCENT);
+    if (fold) {
+        for (pos = len1 = 0; pos < len && len1 < countof(fold_buf); pos++) {
+            c = search_fold_char(buf[pos], fold);
+            if (c != 0 || buf[pos] == 0)
+                fold_buf[len1++] = c;
+        }
+        if (len1 == 0)
+            return 0;
+        buf = fold_buf;
+        len = len1;
+    }
+
     for (offset1 = offset;;) {
         if (dir < 0) {
             if (offset == 0)
@@ -153,18 +208,23 @@ static int eb_search(EditBuffer *b, int dir, int flags,
         /* CG: XXX: Should use buffer specific accelerator */
         /* Get first char separately to compute offset1 */
         c = eb_nextc(b, offset, &offset1);
+        if (fold)
+            c = search_fold_char(c, fold);
 
         pos = 0;
         for (offset2 = offset1;;) {
-            c2 = buf[pos++];
-            if (flags & SEARCH_FLAG_IGNORECASE) {
-                if (qe_toupper(c) != qe_toupper(c2))
-                    break;
-            } else {
-                if (c != c2)
-                    break;
-            }
+            if ((unsigned int)c != buf[pos++])
+                break;
             if (pos >= len) {
+                if (fold & SEARCH_FLAG_IGNOREACCENT) {
+                    /* include trailing diacritics in the match */
+                    while (offset2 < total_size) {
+                        c2 = eb_nextc(b, offset2, &offset3);
+                        if (c2 == 0 || search_fold_char(c2, fold) != 0)
+                            break;
+                        offset2 = offset3;
+                    }
+                }
                 if (flags & SEARCH_FLAG_WORD) {
                     /* check for word boundaries */
                     if (qe_isword(eb_prevc(b, offset, &offset3))
@@ -177,11 +237,405 @@ static int eb_search(EditBuffer *b, int dir, int flags,
                     return 1;
                 }
             }
-            if (offset2 >= total_size)
-                break;
-            c = eb_nextc(b, offset2, &offset2);
+            /* skip diacritics (folded to 0) if ignoring accents */
+            do {
+                if (offset2 >= total_size)
+                    goto next;
+                c2 = eb_nextc(b, offset2, &offset2);
+                c = fold ? search_fold_char(c2, fold) : c2;
+            } while (c == 0 && c2 != 0);
+        }
+    next:
+        continue;
+    }
+}
+
+/*---------------- trigram search index ----------------*/
+
+/* Large mmapped buffers get a search index built in the background
+ * upon the first search: each block of SEARCH_INDEX_BLOCK_SIZE bytes
+ * has a bit filter of the hashed trigrams starting in the block.
+ * Forward searches only scan the blocks whose filter (or that of the
+ * next block for matches straddling the boundary) contains all the
+ * trigrams of the search string.  Trigrams are hashed from raw bytes
+ * with ASCII letters folded to lower case.
+ */
+#define SEARCH_INDEX_BLOCK_SIZE    65536
+#define SEARCH_INDEX_FILTER_SHIFT  14
+#define SEARCH_INDEX_FILTER_BITS   (1 << SEARCH_INDEX_FILTER_SHIFT)
+#define SEARCH_INDEX_FILTER_SIZE   (SEARCH_INDEX_FILTER_BITS / 8)
+#define SEARCH_INDEX_SLICE_MS      20   /* time slice for background build */
+#define SEARCH_INDEX_MAGIC         "QEIDX01\n"
+
+typedef struct SearchIndex {
+    struct SearchIndex *next;
+    EditBuffer *b;
+    int nb_blocks;          /* number of allocated filters */
+    int nb_valid_blocks;    /* number of blocks indexed */
+    int saved;              /* index file is up to date */
+    u8 *filters;            /* nb_blocks * SEARCH_INDEX_FILTER_SIZE */
+} SearchIndex;
+
+typedef struct SearchIndexHeader {
+    char magic[8];
+    int block_size;
+    int filter_bits;
+    int total_size;
+    int nb_blocks;
+    int64_t mtime;
+} SearchIndexHeader;
+
+static SearchIndex *first_search_index;
+static QETimer *search_index_timer;
+
+static inline unsigned int search_index_fold(unsigned int c) {
+    return (c >= 'A' && c <= 'Z') ? c + 'a' - 'A' : c;
+}
+
+static inline unsigned int search_index_hash(unsigned int key) {
+    return (key * 2654435761U) >> (32 - SEARCH_INDEX_FILTER_SHIFT);
+}
+
+static void search_index_callback(EditBuffer *b, void *opaque, int arg,
+                                  enum LogOperation op, int offset, int size)
+{
+    SearchIndex *idx = opaque;
+    /* trigrams starting 2 bytes before offset are affected */
+    int block = max(offset - 2, 0) / SEARCH_INDEX_BLOCK_SIZE;
+
+    if (idx->nb_valid_blocks > block)
+        idx->nb_valid_blocks = block;
+    idx->saved = 0;
+}
+
+/* Return the index for buffer 'b' if any. The callback is checked to
+ * detect stale indexes of freed buffers.
+ */
+static SearchIndex *search_index_find(EditBuffer *b)
+{
+    SearchIndex *idx;
+    EditBufferCallbackList *l;
+
+    for (idx = first_search_index; idx; idx = idx->next) {
+        if (idx->b == b) {
+            for (l = b->first_callback; l != NULL; l = l->next) {
+                if (l->callback == search_index_callback && l->opaque == idx)
+                    return idx;
+            }
         }
     }
+    return NULL;
+}
+
+static int search_index_alloc(SearchIndex *idx)
+{
+    int nb_blocks = (idx->b->total_size + SEARCH_INDEX_BLOCK_SIZE - 1) /
+        SEARCH_INDEX_BLOCK_SIZE;
+
+    if (nb_blocks > idx->nb_blocks) {
+        if (!qe_realloc(&idx->filters, nb_blocks * SEARCH_INDEX_FILTER_SIZE))
+            return -1;
+    }
+    idx->nb_blocks = nb_blocks;
+    if (idx->nb_valid_blocks > nb_blocks)
+        idx->nb_valid_blocks = nb_blocks;
+    return 0;
+}
+
+static void search_index_block(SearchIndex *idx, int block)
+{
+    EditBuffer *b = idx->b;
+    u8 *filter = idx->filters + block * SEARCH_INDEX_FILTER_SIZE;
+    u8 buf[4096];
+    unsigned int key = 0, h;
+    int i, len, n = 0;
+    int offset = block * SEARCH_INDEX_BLOCK_SIZE;
+    /* read 2 more bytes to get all trigrams starting in the block */
+    int end = min(b->total_size, offset + SEARCH_INDEX_BLOCK_SIZE + 2);
+
+    memset(filter, 0, SEARCH_INDEX_FILTER_SIZE);
+    while (offset < end) {
+        len = eb_read(b, offset, buf, min(end - offset, ssizeof(buf)));
+        if (len <= 0)
+            break;
+        for (i = 0; i < len; i++) {
+            key = ((key << 8) | search_index_fold(buf[i])) & 0xFFFFFF;
+            if (++n >= 3) {
+                h = search_index_hash(key);
+                filter[h >> 3] |= 1 << (h & 7);
+            }
+        }
+        offset += len;
+    }
+}
+
+static int search_index_filename(char *buf, int size, EditBuffer *b)
+{
+    if (strlen(b->filename) + sizeof(".qeidx") > (size_t)size)
+        return -1;
+    pstrcpy(buf, size, b->filename);
+    pstrcat(buf, size, ".qeidx");
+    return 0;
+}
+
+static int search_index_load(SearchIndex *idx)
+{
+    EditBuffer *b = idx->b;
+    char filename[MAX_FILENAME_SIZE];
+    SearchIndexHeader hdr;
+    FILE *f;
+    int res = -1;
+
+    if (search_index_filename(filename, sizeof(filename), b))
+        return -1;
+    f = fopen(filename, "rb");
+    if (!f)
+        return -1;
+    if (fread(&hdr, sizeof(hdr), 1, f) == 1
+    &&  !memcmp(hdr.magic, SEARCH_INDEX_MAGIC, sizeof(hdr.magic))
+    &&  hdr.block_size == SEARCH_INDEX_BLOCK_SIZE
+    &&  hdr.filter_bits == SEARCH_INDEX_FILTER_BITS
+    &&  hdr.total_size == b->total_size
+    &&  hdr.nb_blocks == idx->nb_blocks
+    &&  hdr.mtime == (int64_t)b->mtime
+    &&  fread(idx->filters, SEARCH_INDEX_FILTER_SIZE, idx->nb_blocks, f) ==
+        (size_t)idx->nb_blocks) {
+        idx->nb_valid_blocks = idx->nb_blocks;
+        idx->saved = 1;
+        res = 0;
+    }
+    fclose(f);
+    return res;
+}
+
+static void search_index_save(SearchIndex *idx)
+{
+    EditBuffer *b = idx->b;
+    char filename[MAX_FILENAME_SIZE];
+    SearchIndexHeader hdr;
+    FILE *f;
+
+    /* only save the index of the file contents */
+    idx->saved = 1;
+    if (!qe_state.search_index_save || b->modified || !*b->filename)
+        return;
+
+    if (search_index_filename(filename, sizeof(filename), b))
+        return;
+    f = fopen(filename, "wb");
+    if (!f)
+        return;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, SEARCH_INDEX_MAGIC, sizeof(hdr.magic));
+    hdr.block_size = SEARCH_INDEX_BLOCK_SIZE;
+    hdr.filter_bits = SEARCH_INDEX_FILTER_BITS;
+    hdr.total_size = b->total_size;
+    hdr.nb_blocks = idx->nb_blocks;
+    hdr.mtime = b->mtime;
+    if (fwrite(&hdr, sizeof(hdr), 1, f) != 1
+    ||  fwrite(idx->filters, SEARCH_INDEX_FILTER_SIZE, idx->nb_blocks, f) !=
+        (size_t)idx->nb_blocks) {
+        fclose(f);
+        remove(filename);
+        return;
+    }
+    fclose(f);
+}
+
+static void search_index_free(SearchIndex **pidx)
+{
+    SearchIndex *idx = *pidx;
+
+    *pidx = idx->next;
+    qe_free(&idx->filters);
+    qe_free(&idx);
+}
+
+/* Build the search indexes by time slices, yield to user input */
+static void search_index_timer_cb(qe__unused__ void *opaque)
+{
+    SearchIndex *idx, **pidx;
+    int start_time = get_clock_ms();
+
+    search_index_timer = NULL;
+    for (pidx = &first_search_index; (idx = *pidx) != NULL;) {
+        if (!check_buffer(&idx->b) || search_index_find(idx->b) != idx
+        ||  search_index_alloc(idx)) {
+            search_index_free(pidx);
+            continue;
+        }
+        while (idx->nb_valid_blocks < idx->nb_blocks) {
+            if (get_clock_ms() - start_time >= SEARCH_INDEX_SLICE_MS
+            ||  is_user_input_pending()) {
+                search_index_timer = qe_add_timer(1, NULL, search_index_timer_cb);
+                return;
+            }
+            search_index_block(idx, idx->nb_valid_blocks++);
+        }
+        if (!idx->saved)
+            search_index_save(idx);
+        pidx = &idx->next;
+    }
+}
+
+static void search_index_update(void)
+{
+    if (!search_index_timer)
+        search_index_timer = qe_add_timer(0, NULL, search_index_timer_cb);
+}
+
+static SearchIndex *search_index_new(EditBuffer *b)
+{
+    SearchIndex *idx;
+
+    idx = qe_mallocz(SearchIndex);
+    if (!idx)
+        return NULL;
+    idx->b = b;
+    if (search_index_alloc(idx)
+    ||  eb_add_callback(b, search_index_callback, idx, 0)) {
+        qe_free(&idx->filters);
+        qe_free(&idx);
+        return NULL;
+    }
+    idx->next = first_search_index;
+    first_search_index = idx;
+    if (*b->filename && !b->modified)
+        search_index_load(idx);
+    search_index_update();
+    return idx;
+}
+
+/* Compute the hashed trigrams of the search string as encoded in the
+ * buffer. Return the number of trigrams.
+ */
+static int search_index_trigrams(EditBuffer *b, int flags,
+                                 const unsigned int *buf, int len,
+                                 unsigned int *hashes, int size)
+{
+    u8 bytes[SEARCH_LENGTH * MAX_CHAR_BYTES];
+    u8 usable[SEARCH_LENGTH * MAX_CHAR_BYTES];
+    char cbuf[MAX_CHAR_BYTES];
+    unsigned int key = 0;
+    int i, j, n, clen, run = 0, count = 0;
+
+    flags = search_smartcase_flags(flags, buf, len);
+    for (i = n = 0; i < len && i < SEARCH_LENGTH; i++) {
+        unsigned int c = buf[i];
+        /* non ASCII characters may match a different encoding when
+           ignoring case or accents, so may letters with accents.
+           Line endings may be translated.  When ignoring case, i, s
+           and k also match the non ASCII letters that fold to them
+           (dotted and dotless i, long s, Kelvin sign).
+         */
+        int ok = (c != '\n') &&
+            (c < 128 || !(flags & (SEARCH_FLAG_IGNORECASE |
+                                   SEARCH_FLAG_IGNOREACCENT))) &&
+            !((flags & SEARCH_FLAG_IGNOREACCENT) && qe_isalpha(c)) &&
+            !((flags & SEARCH_FLAG_IGNORECASE) && qe_findchar("iskISK", c));
+        if (flags & SEARCH_FLAG_HEX) {
+            cbuf[0] = c;
+            clen = 1;
+            ok = 1;
+        } else {
+            clen = eb_encode_uchar(b, cbuf, c);
+        }
+        for (j = 0; j < clen; j++) {
+            bytes[n] = search_index_fold((u8)cbuf[j]);
+            usable[n++] = ok;
+        }
+    }
+    for (i = 0; i < n && count < size; i++) {
+        run = usable[i] ? run + 1 : 0;
+        key = ((key << 8) | bytes[i]) & 0xFFFFFF;
+        if (run >= 3)
+            hashes[count++] = search_index_hash(key);
+    }
+    return count;
+}
+
+static int search_index_match(SearchIndex *idx, int block,
+                              const unsigned int *hashes, int count)
+{
+    const u8 *f1 = idx->filters + block * SEARCH_INDEX_FILTER_SIZE;
+    const u8 *f2 = NULL;
+    int i, h;
+
+    if (block + 1 < idx->nb_blocks) {
+        /* matches may straddle the block boundary */
+        if (block + 1 >= idx->nb_valid_blocks)
+            return 1;
+        f2 = f1 + SEARCH_INDEX_FILTER_SIZE;
+    }
+    for (i = 0; i < count; i++) {
+        h = hashes[i];
+        if (!((f1[h >> 3] | (f2 ? f2[h >> 3] : 0)) & (1 << (h & 7))))
+            return 0;
+    }
+    return 1;
+}
+
+static int eb_search(EditBuffer *b, int dir, int flags,
+                     int start_offset, int end_offset,
+                     const unsigned int *buf, int len,
+                     CSSAbortFunc *abort_func, void *abort_opaque,
+                     int *found_offset, int *found_end)
+{
+    unsigned int hashes[SEARCH_LENGTH * MAX_CHAR_BYTES];
+    SearchIndex *idx;
+    int count, block, offset, offset1, res;
+
+    /* XXX: backward searches are not accelerated */
+    if (!b->map_address || dir < 0 || len == 0)
+        goto scan;
+
+    idx = search_index_find(b);
+    if (!idx) {
+        /* load the index or build it in the background */
+        idx = search_index_new(b);
+        if (!idx)
+            goto scan;
+    } else
+    if (search_index_alloc(idx)) {
+        goto scan;
+    }
+    count = search_index_trigrams(b, flags, buf, len,
+                                  hashes, countof(hashes));
+    if (count == 0)
+        goto scan;
+
+    if (end_offset > b->total_size)
+        end_offset = b->total_size;
+
+    *found_offset = -1;
+    *found_end = -1;
+
+    offset = start_offset;
+    block = offset / SEARCH_INDEX_BLOCK_SIZE;
+    while (offset < end_offset && block < idx->nb_valid_blocks) {
+        offset1 = min(end_offset, (block + 1) * SEARCH_INDEX_BLOCK_SIZE);
+        if (search_index_match(idx, block, hashes, count)) {
+            res = eb_search1(b, dir, flags, offset, offset1, buf, len,
+                             abort_func, abort_opaque, found_offset, found_end);
+            if (res != 0)
+                return res;
+        } else
+        if ((block & 15) == 0) {
+            /* check for search abort every megabyte */
+            if (abort_func && abort_func(abort_opaque))
+                return -1;
+        }
+        /* realign on a character boundary */
+        offset = eb_next(b, eb_prev(b, offset1));
+        block++;
+    }
+    start_offset = offset;
+    if (start_offset >= end_offset)
+        return 0;
+
+ scan:
+    return eb_search1(b, dir, flags, start_offset, end_offset, buf, len,
+                      abort_func, abort_opaque, found_offset, found_end);
 }
 
 static int search_abort_func(qe__unused__ void *opaque)
@@ -229,6 +683,8 @@ static void buf_disp_search_flags(buf_t *out, int search_flags) {
     else
     if (!(search_flags & SEARCH_FLAG_SMARTCASE))
         buf_puts(out, "Exact ");
+    if (search_flags & SEARCH_FLAG_IGNOREACCENT)
+        buf_puts(out, "Char-fold ");
     if (search_flags & SEARCH_FLAG_REGEX)
         buf_puts(out, "Regex ");
     if (search_flags & SEARCH_FLAG_WORD)
@@ -453,6 +909,10 @@ static void isearch_toggle_case_fold(ISearchState *is) {
     isearch_cycle_flags(is, SEARCH_FLAG_IGNORECASE | SEARCH_FLAG_SMARTCASE);
 }
 
+static void isearch_toggle_accent_fold(ISearchState *is) {
+    isearch_cycle_flags(is, SEARCH_FLAG_IGNOREACCENT);
+}
+
 static void isearch_toggle_hex(ISearchState *is) {
     isearch_cycle_flags(is, SEARCH_FLAG_HEX | SEARCH_FLAG_UNIHEX);
 }
@@ -657,7 +1117,7 @@ void do_isearch(EditState *s, int argval, int dir)
 {
     ISearchState *is = &global_isearch_state;
     EditState *e;
-    int flags = SEARCH_FLAG_SMARTCASE | SEARCH_FLAG_ACTIVE;
+    int flags = search_default_flags() | SEARCH_FLAG_ACTIVE;
 
     /* prevent search from minibuffer */
     if (s->flags & WF_MINIBUF)
@@ -709,18 +1169,19 @@ void isearch_colorize_matches(EditState *s, unsigned int *buf, int len,
     while (eb_search(b, 1, is->search_flags, offset, offset_end,
                      is->search_u32, is->search_u32_len, NULL, NULL,
                      &found_offset, &found_end) > 0) {
-        int line, start, stop, i;
+        int start, stop, i;
 
         if (found_offset >= offset_end)
             break;
         if (found_end > offset_start) {
-            /* Compute character positions */
+            /* Compute character positions, `offset_start` may be in
+               the middle of a long line */
             start = 0;
             if (found_offset > offset_start)
-                eb_get_pos(b, &line, &start, found_offset);
+                start = eb_get_char_offset(b, found_offset) - char_offset;
             stop = len;
             if (found_end < offset_end) {
-                eb_get_pos(b, &line, &stop, found_end);
+                stop = eb_get_char_offset(b, found_end) - char_offset;
                 if (stop > len)
                     stop = len;
             }
@@ -772,6 +1233,101 @@ static int search_to_u32(unsigned int *buf, int size,
     }
 }
 
+/* Create a scratch buffer to collect the new contents of 'b' */
+static EditBuffer *search_new_tmp_buffer(EditBuffer *b)
+{
+    EditBuffer *b1;
+
+    b1 = eb_new("*tmp*", BF_SYSTEM | (b->flags & BF_STYLES));
+    if (b1)
+        eb_set_charset(b1, b->charset, b->eol_type);
+    return b1;
+}
+
+/* Delete (dir=2) or keep (dir=3) the lines containing the search string
+ * from 'offset' to the end of the buffer.  The buffer is scanned once,
+ * the remaining lines are collected in a scratch buffer whose pages are
+ * swapped in with a single undo step.
+ * Return the number of matching lines.
+ */
+static int search_rebuild_lines(EditBuffer *b, int dir, int flags, int offset,
+                                const unsigned int *buf, int len)
+{
+    EditBuffer *b1;
+    int found_offset, found_end, bol, start, count = 0;
+
+    b1 = search_new_tmp_buffer(b);
+    if (!b1)
+        return 0;
+
+    start = offset;
+    while (eb_search(b, 1, flags, offset, b->total_size, buf, len,
+                     NULL, NULL, &found_offset, &found_end) > 0) {
+        bol = eb_goto_bol(b, found_offset);
+        if (dir == 2) {
+            /* leave the lines before the first match untouched */
+            if (count == 0)
+                start = offset = bol;
+            eb_insert_buffer_convert(b1, b1->total_size, b, offset,
+                                     bol - offset);
+        }
+        offset = eb_next_line(b, found_offset);
+        if (dir == 3) {
+            eb_insert_buffer_convert(b1, b1->total_size, b, bol,
+                                     offset - bol);
+        }
+        count++;
+    }
+    if (dir == 3 || count > 0) {
+        if (dir == 2) {
+            eb_insert_buffer_convert(b1, b1->total_size, b, offset,
+                                     b->total_size - offset);
+        }
+        eb_replace_buffer(b, start, b->total_size - start, b1);
+    }
+    eb_free(&b1);
+    return count;
+}
+
+/* Replace all matches of the search string from 'offset' to the end of
+ * the buffer in a single pass with a single undo step.  Store the end
+ * of the last replacement to '*end_ptr'.
+ * Return the number of replacements.
+ */
+static int search_replace_all(EditBuffer *b, int flags, int offset,
+                              const unsigned int *buf, int len,
+                              const unsigned int *rep, int rep_len,
+                              int *end_ptr)
+{
+    EditBuffer *b1;
+    int found_offset, found_end, start = offset, count = 0;
+
+    b1 = search_new_tmp_buffer(b);
+    if (!b1)
+        return 0;
+
+    while (eb_search(b, 1, flags, offset, b->total_size, buf, len,
+                     NULL, NULL, &found_offset, &found_end) > 0) {
+        /* leave the text before the first match untouched */
+        if (count == 0)
+            start = offset = found_offset;
+        /* XXX: handle smart case replacement */
+        eb_insert_buffer_convert(b1, b1->total_size, b, offset,
+                                 found_offset - offset);
+        eb_insert_u32_buf(b1, b1->total_size, rep, rep_len);
+        offset = found_end;
+        count++;
+    }
+    if (count > 0) {
+        /* end_ptr may be updated by the buffer callbacks */
+        len = b1->total_size;
+        eb_replace_buffer(b, start, offset - start, b1);
+        *end_ptr = start + len;
+    }
+    eb_free(&b1);
+    return count;
+}
+
 typedef struct QueryReplaceState {
     EditState *s;
     int search_flags;
@@ -827,19 +1383,21 @@ static void query_replace_display(QueryReplaceState *is)
                                         countof(is->replace_u32),
                                         is->replace_str, is->search_flags);
 
-    for (;;) {
-        if (eb_search(s->b, 1, is->search_flags,
-                      is->found_offset, s->b->total_size,
-                      is->search_u32, is->search_u32_len,
-                      NULL, NULL, &is->found_offset, &is->found_end) <= 0) {
-            query_replace_abort(is);
-            return;
-        }
-        if (is->replace_all) {
-            query_replace_replace(is);
-            continue;
-        }
-        break;
+    if (is->replace_all) {
+        is->nb_reps += search_replace_all(s->b, is->search_flags,
+                                          is->found_offset,
+                                          is->search_u32, is->search_u32_len,
+                                          is->replace_u32, is->replace_u32_len,
+                                          &s->offset);
+        query_replace_abort(is);
+        return;
+    }
+    if (eb_search(s->b, 1, is->search_flags,
+                  is->found_offset, s->b->total_size,
+                  is->search_u32, is->search_u32_len,
+                  NULL, NULL, &is->found_offset, &is->found_end) <= 0) {
+        query_replace_abort(is);
+        return;
     }
     /* display prompt string */
     out = buf_init(&outbuf, ubuf, sizeof(ubuf));
@@ -971,14 +1529,14 @@ static void query_replace(EditState *s, const char *search_str,
 void do_query_replace(EditState *s, const char *search_str,
                       const char *replace_str)
 {
-    int flags = SEARCH_FLAG_SMARTCASE;
+    int flags = search_default_flags();
     query_replace(s, search_str, replace_str, 0, flags);
 }
 
 void do_replace_string(EditState *s, const char *search_str,
                        const char *replace_str, int argval)
 {
-    int flags = SEARCH_FLAG_SMARTCASE;
+    int flags = search_default_flags();
     if (argval != 1)
         flags |= SEARCH_FLAG_WORD;
     query_replace(s, search_str, replace_str, 1, flags);
@@ -991,8 +1549,8 @@ void do_search_string(EditState *s, const char *search_str, int dir)
     unsigned int search_u32[SEARCH_LENGTH];
     int search_u32_len;
     int found_offset, found_end;
-    int flags = SEARCH_FLAG_SMARTCASE;
-    int offset, offset1, count = 0;
+    int flags = search_default_flags();
+    int offset, count = 0;
 
     if (s->hex_mode) {
         if (s->unihex_mode)
@@ -1007,8 +1565,16 @@ void do_search_string(EditState *s, const char *search_str, int dir)
         return;
 
     offset = s->offset;
-    if (dir == 2 || dir == 3)
+    if (dir == 2 || dir == 3) {
         offset = eb_goto_bol(s->b, offset);
+        count = search_rebuild_lines(s->b, dir, flags, offset,
+                                     search_u32, search_u32_len);
+        if (dir == 2)
+            put_status(s, "deleted %d lines", count);
+        else
+            put_status(s, "filtered %d lines", count);
+        return;
+    }
 
     while (eb_search(s->b, dir, flags,
                      offset, s->b->total_size,
@@ -1028,28 +1594,12 @@ void do_search_string(EditState *s, const char *search_str, int dir)
             s->offset = found_end;
             do_center_cursor(s, 0);
             return;
-        case 2:
-            offset = eb_goto_bol(s->b, found_offset);
-            eb_delete_range(s->b, offset, eb_next_line(s->b, found_offset));
-            continue;
-        case 3:
-            offset1 = eb_goto_bol(s->b, found_offset);
-            eb_delete_range(s->b, offset, offset1);
-            offset = eb_next_line(s->b, offset);
-            continue;
         }
     }
     switch (dir) {
     case 0:
         put_status(s, "%d matches", count);
         break;
-    case 2:
-        put_status(s, "deleted %d lines", count);
-        break;
-    case 3:
-        eb_delete_range(s->b, offset, s->b->total_size);
-        put_status(s, "filtered %d lines", count);
-        break;
     case -1:
     case 1:
         put_status(s, "Search failed: \"%s\"", search_str);
@@ -1057,6 +1607,558 @@ void do_search_string(EditState *s, const char *search_str, int dir)
     }
 }
 
+/*---------------- occur mode ----------------*/
+
+/* The occur buffer lists the lines matching a string in one or more
+ * source buffers: a header line per source followed by a line per
+ * matching line.  The back references are kept in a sorted array per
+ * source, updated by a buffer callback as the property list is.
+ * Modified lines are scanned again by a timer and only the
+ * corresponding lines of the occur buffer are replaced.
+ */
+
+#define OCCUR_CHUNK_SIZE    (16 * MAX_PAGE_SIZE)  /* scan by groups of pages */
+#define OCCUR_SLICE_MS      20
+#define OCCUR_UPDATE_DELAY  100   /* delay before scanning modified lines */
+#define OCCUR_LINE_MAX      256   /* truncate long lines in the occur buffer */
+
+typedef struct OccurMatch {
+    int offset;     /* offset of the matching line in the source buffer */
+    int line_num;   /* 0 based line number */
+} OccurMatch;
+
+typedef struct OccurSource {
+    EditBuffer *b;  /* NULL once the buffer has been killed */
+    char name[MAX_BUFFERNAME_SIZE];
+    int killed;
+    int nb_matches, max_matches;
+    OccurMatch *matches;        /* sorted by offset */
+    int dirty_start, dirty_end; /* range to scan, empty if start > end */
+} OccurSource;
+
+typedef struct OccurState {
+    QEModeData base;
+    int search_flags;
+    int search_u32_len;
+    unsigned int search_u32[SEARCH_LENGTH];
+    char search_str[SEARCH_LENGTH];
+    int nb_sources;
+    OccurSource *sources;
+    QETimer *timer;
+} OccurState;
+
+static ModeDef occur_mode;
+
+static void occur_timer_cb(void *opaque);
+
+static inline OccurState *occur_get_state(EditState *e, int status)
+{
+    return qe_get_buffer_mode_data(e->b, &occur_mode, status ? e : NULL);
+}
+
+/* Find the index of the first match at or after 'offset' */
+static int occur_find_match(OccurSource *src, int offset)
+{
+    int lo = 0, hi = src->nb_matches;
+
+    while (lo < hi) {
+        int mid = (lo + hi) >> 1;
+        if (src->matches[mid].offset < offset)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+static void occur_set_dirty(OccurSource *src, int start, int end)
+{
+    if (src->dirty_start > src->dirty_end) {
+        src->dirty_start = start;
+        src->dirty_end = end;
+    } else {
+        src->dirty_start = min(src->dirty_start, start);
+        src->dirty_end = max(src->dirty_end, end);
+    }
+}
+
+static void occur_source_callback(qe__unused__ EditBuffer *b, void *opaque,
+                                  int arg, enum LogOperation op,
+                                  int offset, int size)
+{
+    OccurState *os = opaque;
+    OccurSource *src = &os->sources[arg];
+    OccurMatch *m = src->matches + occur_find_match(src, offset + 1);
+    OccurMatch *end = src->matches + src->nb_matches;
+    int dirty = (src->dirty_start <= src->dirty_end);
+
+    switch (op) {
+    case LOGOP_INSERT:
+        for (; m < end; m++)
+            m->offset += size;
+        if (dirty) {
+            if (src->dirty_start > offset)
+                src->dirty_start += size;
+            if (src->dirty_end > offset)
+                src->dirty_end += size;
+        }
+        occur_set_dirty(src, offset, offset + size);
+        break;
+    case LOGOP_DELETE:
+        /* lines starting in the deleted block are moved to its start,
+         * they will be scanned again */
+        for (; m < end; m++)
+            m->offset = max(m->offset - size, offset);
+        if (dirty) {
+            if (src->dirty_start > offset)
+                src->dirty_start = max(src->dirty_start - size, offset);
+            if (src->dirty_end > offset)
+                src->dirty_end = max(src->dirty_end - size, offset);
+        }
+        occur_set_dirty(src, offset, offset);
+        break;
+    case LOGOP_WRITE:
+        occur_set_dirty(src, offset, offset + size);
+        break;
+    default:
+        return;
+    }
+    if (!os->timer)
+        os->timer = qe_add_timer(OCCUR_UPDATE_DELAY, os, occur_timer_cb);
+}
+
+/* Return the source buffer if it still exists: its callback list is
+ * freed along with it, which also protects against address reuse.
+ */
+static EditBuffer *occur_source_buffer(OccurState *os, int n)
+{
+    OccurSource *src = &os->sources[n];
+    EditBufferCallbackList *l;
+
+    if (check_buffer(&src->b)) {
+        for (l = src->b->first_callback; l; l = l->next) {
+            if (l->callback == occur_source_callback
+            &&  l->opaque == os && l->arg == n)
+                return src->b;
+        }
+        src->b = NULL;
+    }
+    return NULL;
+}
+
+/* Return the line number of the header of source 'n' */
+static int occur_source_line(OccurState *os, int n)
+{
+    int i, line = 0;
+
+    for (i = 0; i < n; i++)
+        line += 1 + os->sources[i].nb_matches;
+    return line;
+}
+
+static void occur_update_header(OccurState *os, EditBuffer *b, int n)
+{
+    OccurSource *src = &os->sources[n];
+    char buf[MAX_BUFFERNAME_SIZE + SEARCH_LENGTH + 64];
+    int offset;
+
+    snprintf(buf, sizeof(buf), "%d match%s for \"%s\" in buffer: %s%s",
+             src->nb_matches, src->nb_matches == 1 ? "" : "es",
+             os->search_str, src->name, src->killed ? " (killed)" : "");
+    offset = eb_goto_pos(b, occur_source_line(os, n), 0);
+    eb_delete(b, offset, eb_goto_eol(b, offset) - offset);
+    eb_insert_str(b, offset, buf);
+}
+
+/* Insert the line for match 'm' at 'offset', return its size */
+static int occur_insert_match(EditBuffer *b, int offset,
+                              OccurSource *src, const OccurMatch *m)
+{
+    char buf[32];
+    int start = offset, end;
+
+    snprintf(buf, sizeof(buf), "%7d:", m->line_num + 1);
+    offset += eb_insert_str(b, offset, buf);
+    end = min(eb_goto_eol(src->b, m->offset),
+              eb_skip_chars(src->b, m->offset, OCCUR_LINE_MAX));
+    offset += eb_insert_buffer_convert(b, offset, src->b, m->offset,
+                                       end - m->offset);
+    offset += eb_insert_uchar(b, offset, '\n');
+    return offset - start;
+}
+
+/* Scan the lines of source 'n' from 'start' to 'end' and replace the
+ * corresponding lines of the occur buffer.
+ */
+static void occur_scan_range(OccurState *os, EditBuffer *b, int n,
+                             int start, int end)
+{
+    OccurSource *src = &os->sources[n];
+    EditBuffer *b1 = src->b;
+    OccurMatch *tab = NULL;
+    int nb = 0, max_nb = 0, j0, j1, nb_matches, delta;
+    int offset, found_offset, found_end, line, col, i;
+    char buf[32];
+
+    for (offset = start; offset < end; offset = eb_next_line(b1, found_offset)) {
+        if (eb_search(b1, 1, os->search_flags, offset, end,
+                      os->search_u32, os->search_u32_len,
+                      NULL, NULL, &found_offset, &found_end) <= 0)
+            break;
+        if (nb >= max_nb) {
+            max_nb = max_nb ? max_nb * 2 : 16;
+            if (!qe_realloc(&tab, max_nb * sizeof(*tab)))
+                break;
+        }
+        tab[nb].offset = eb_goto_bol(b1, found_offset);
+        eb_get_pos(b1, &tab[nb].line_num, &col, tab[nb].offset);
+        nb++;
+    }
+
+    j0 = occur_find_match(src, start);
+    j1 = occur_find_match(src, end);
+    nb_matches = src->nb_matches - (j1 - j0) + nb;
+    if (nb_matches > src->max_matches) {
+        int max_matches = max(nb_matches, src->max_matches * 2);
+        if (!qe_realloc(&src->matches, max_matches * sizeof(*src->matches))) {
+            qe_free(&tab);
+            return;
+        }
+        src->max_matches = max_matches;
+    }
+    memmove(src->matches + j0 + nb, src->matches + j1,
+            (src->nb_matches - j1) * sizeof(*src->matches));
+    if (nb)
+        memcpy(src->matches + j0, tab, nb * sizeof(*tab));
+    qe_free(&tab);
+
+    line = occur_source_line(os, n) + 1 + j0;
+    offset = eb_goto_pos(b, line, 0);
+    eb_delete(b, offset, eb_goto_pos(b, line + j1 - j0, 0) - offset);
+    for (i = j0; i < j0 + nb; i++)
+        offset += occur_insert_match(b, offset, src, &src->matches[i]);
+
+    /* renumber the following lines if the line count changed */
+    if (i < nb_matches) {
+        eb_get_pos(b1, &line, &col, src->matches[i].offset);
+        delta = line - src->matches[i].line_num;
+        if (delta) {
+            for (; i < nb_matches; i++) {
+                OccurMatch *m = &src->matches[i];
+                eb_delete(b, offset, snprintf(buf, sizeof(buf), "%7d:",
+                                              m->line_num + 1));
+                m->line_num += delta;
+                snprintf(buf, sizeof(buf), "%7d:", m->line_num + 1);
+                eb_insert_str(b, offset, buf);
+                offset = eb_next_line(b, offset);
+            }
+        }
+    }
+    /* update the header last, it shifts the offsets of the lines below */
+    if (nb != j1 - j0) {
+        src->nb_matches = nb_matches;
+        occur_update_header(os, b, n);
+    }
+}
+
+/* Remove the matches of a source whose buffer was killed */
+static void occur_kill_source(OccurState *os, EditBuffer *b, int n)
+{
+    OccurSource *src = &os->sources[n];
+    int line = occur_source_line(os, n) + 1;
+    int offset = eb_goto_pos(b, line, 0);
+
+    eb_delete(b, offset, eb_goto_pos(b, line + src->nb_matches, 0) - offset);
+    src->nb_matches = 0;
+    src->killed = 1;
+    occur_update_header(os, b, n);
+}
+
+static void occur_timer_cb(void *opaque)
+{
+    OccurState *os = opaque;
+    QEmacsState *qs = &qe_state;
+    EditBuffer *b = os->base.b;
+    int start_time = get_clock_ms();
+    int n, start, end, pending = 0, save_readonly;
+
+    os->timer = NULL;
+
+    /* Suspend BF_READONLY flag to allow updating the list */
+    save_readonly = b->flags & BF_READONLY;
+    b->flags &= ~BF_READONLY;
+    for (n = 0; n < os->nb_sources && !pending; n++) {
+        OccurSource *src = &os->sources[n];
+        if (!occur_source_buffer(os, n)) {
+            if (!src->killed)
+                occur_kill_source(os, b, n);
+            continue;
+        }
+        /* scan modified lines by chunks of pages */
+        while (src->dirty_start <= src->dirty_end) {
+            if (get_clock_ms() - start_time >= OCCUR_SLICE_MS
+            ||  is_user_input_pending()) {
+                pending = 1;
+                break;
+            }
+            start = eb_goto_bol(src->b, src->dirty_start);
+            end = src->dirty_end;
+            if (end - start > OCCUR_CHUNK_SIZE) {
+                end = eb_next_line(src->b, start + OCCUR_CHUNK_SIZE);
+                src->dirty_start = end;
+            } else {
+                end = eb_next_line(src->b, end);
+                src->dirty_start = 1;
+                src->dirty_end = 0;
+            }
+            occur_scan_range(os, b, n, start, end);
+        }
+    }
+    b->flags |= save_readonly;
+    b->modified = 0;
+
+    if (pending)
+        os->timer = qe_add_timer(0, os, occur_timer_cb);
+
+    /* now we do some refresh */
+    edit_display_request(qs);
+}
+
+static int occur_add_source(OccurState *os, EditBuffer *b1)
+{
+    OccurSource *src;
+    int n;
+
+    for (n = 0; n < os->nb_sources; n++) {
+        if (os->sources[n].b == b1)
+            return 0;
+    }
+    if (!qe_realloc(&os->sources, (n + 1) * sizeof(*os->sources)))
+        return -1;
+    src = &os->sources[n];
+    memset(src, 0, sizeof(*src));
+    src->b = b1;
+    pstrcpy(src->name, sizeof(src->name), b1->name);
+    src->dirty_start = 0;
+    src->dirty_end = b1->total_size;
+    os->nb_sources++;
+    return 0;
+}
+
+/* List the lines matching 'search_str' in the current buffer or in the
+ * buffers listed in 'bufnames', in all user buffers if it is empty.
+ */
+static void occur_start(EditState *s, const char *search_str,
+                        const char *bufnames)
+{
+    QEmacsState *qs = s->qe_state;
+    EditBuffer *b, *b1;
+    OccurState *os;
+    unsigned int search_u32[SEARCH_LENGTH];
+    char name[MAX_BUFFERNAME_SIZE];
+    const char *p;
+    int n, len, search_u32_len;
+
+    /* ignore command from the minibuffer and popups */
+    if (s->flags & (WF_POPUP | WF_MINIBUF))
+        return;
+
+    search_u32_len = search_to_u32(search_u32, countof(search_u32),
+                                   search_str, search_default_flags());
+    /* empty string matches */
+    if (search_u32_len <= 0)
+        return;
+
+    b = eb_find("*occur*");
+    if (b) {
+        if (s->b == b && !bufnames) {
+            put_status(s, "Cannot search the occur buffer");
+            return;
+        }
+        qe_kill_buffer(b);
+    }
+    b = eb_new("*occur*", BF_UTF8);
+    if (!b)
+        return;
+    b1 = s->b;
+
+    switch_to_buffer(s, b);
+    edit_set_mode(s, &occur_mode);
+    if (!(os = occur_get_state(s, 1)))
+        return;
+
+    os->search_flags = search_default_flags();
+    os->search_u32_len = search_u32_len;
+    memcpy(os->search_u32, search_u32, search_u32_len * sizeof(*search_u32));
+    pstrcpy(os->search_str, sizeof(os->search_str), search_str);
+
+    if (!bufnames) {
+        occur_add_source(os, b1);
+    } else
+    if (!*bufnames) {
+        for (b1 = qs->first_buffer; b1; b1 = b1->next) {
+            /* skip system and special buffers */
+            if (!(b1->flags & BF_SYSTEM) && *b1->name != '*'
+            &&  !qe_get_buffer_mode_data(b1, &occur_mode, NULL))
+                occur_add_source(os, b1);
+        }
+    } else {
+        for (p = bufnames;;) {
+            p += strspn(p, " ,");
+            if (!*p)
+                break;
+            len = strcspn(p, " ,");
+            pstrncpy(name, sizeof(name), p, len);
+            p += len;
+            b1 = eb_find(name);
+            if (!b1) {
+                put_status(s, "No buffer %s", name);
+                continue;
+            }
+            if (!qe_get_buffer_mode_data(b1, &occur_mode, NULL))
+                occur_add_source(os, b1);
+        }
+    }
+
+    for (n = 0; n < os->nb_sources; n++) {
+        eb_add_callback(os->sources[n].b, occur_source_callback, os, n);
+        eb_insert_uchar(b, b->total_size, '\n');
+        occur_update_header(os, b, n);
+    }
+    b->modified = 0;
+    b->flags |= BF_READONLY;
+    s->offset = 0;
+
+    os->timer = qe_add_timer(0, os, occur_timer_cb);
+}
+
+static void do_occur(EditState *s, const char *search_str)
+{
+    occur_start(s, search_str, NULL);
+}
+
+static void do_multi_occur(EditState *s, const char *search_str,
+                           const char *bufnames)
+{
+    occur_start(s, search_str, bufnames);
+}
+
+/* Go to the match on the current line of the occur buffer */
+static void occur_goto(EditState *s, int stay)
+{
+    QEmacsState *qs = s->qe_state;
+    OccurState *os;
+    OccurSource *src;
+    EditBuffer *b1;
+    EditState *e;
+    int line, col, n, offset, found_offset, found_end;
+
+    if (!(os = occur_get_state(s, 1)))
+        return;
+
+    eb_get_pos(s->b, &line, &col, s->offset);
+    for (n = 0; n < os->nb_sources; n++) {
+        if (line <= os->sources[n].nb_matches)
+            break;
+        line -= 1 + os->sources[n].nb_matches;
+    }
+    if (n == os->nb_sources)
+        return;
+    src = &os->sources[n];
+    if (!(b1 = occur_source_buffer(os, n))) {
+        put_status(s, "Buffer %s was killed", src->name);
+        return;
+    }
+    e = eb_find_window(b1, NULL);
+    if (!e) {
+        /* use another window if possible */
+        for (e = qs->first_window; e; e = e->next_window) {
+            if (e != s && !(e->flags & (WF_POPUP | WF_MINIBUF | WF_POPLEFT)))
+                break;
+        }
+        if (!e)
+            e = s;
+        switch_to_buffer(e, b1);
+    }
+    if (line > 0) {
+        /* header line selects the buffer, leaving point unchanged */
+        offset = src->matches[line - 1].offset;
+        if (eb_search(b1, 1, os->search_flags, offset,
+                      eb_next_line(b1, offset),
+                      os->search_u32, os->search_u32_len,
+                      NULL, NULL, &found_offset, &found_end) > 0)
+            offset = found_offset;
+        e->offset = offset;
+    }
+    if (!stay || e == s)
+        qs->active_window = e;
+}
+
+static void occur_refresh(EditState *s)
+{
+    OccurState *os;
+    int n;
+
+    if (!(os = occur_get_state(s, 1)))
+        return;
+
+    for (n = 0; n < os->nb_sources; n++) {
+        OccurSource *src = &os->sources[n];
+        if (occur_source_buffer(os, n))
+            occur_set_dirty(src, 0, src->b->total_size);
+    }
+    if (!os->timer)
+        os->timer = qe_add_timer(0, os, occur_timer_cb);
+}
+
+static void occur_display_hook(EditState *s)
+{
+    OccurState *os = occur_get_state(s, 0);
+    int n;
+
+    /* detect killed source buffers */
+    if (os && !os->timer) {
+        for (n = 0; n < os->nb_sources; n++) {
+            if (!os->sources[n].killed && !occur_source_buffer(os, n)) {
+                os->timer = qe_add_timer(0, os, occur_timer_cb);
+                break;
+            }
+        }
+    }
+    if (list_mode.display_hook)
+        list_mode.display_hook(s);
+}
+
+static int occur_mode_probe(ModeDef *mode, ModeProbeData *p)
+{
+    if (qe_get_buffer_mode_data(p->b, &occur_mode, NULL))
+        return 95;
+
+    return 0;
+}
+
+static int occur_mode_init(EditState *s, EditBuffer *b, int flags)
+{
+    if (!qe_get_buffer_mode_data(b, &occur_mode, NULL))
+        return -1;
+
+    return list_mode.mode_init(s, b, flags);
+}
+
+static void occur_mode_free(qe__unused__ EditBuffer *b, void *state)
+{
+    OccurState *os = state;
+    int n;
+
+    qe_kill_timer(&os->timer);
+    for (n = 0; n < os->nb_sources; n++) {
+        if (occur_source_buffer(os, n))
+            eb_free_callback(os->sources[n].b, occur_source_callback, os);
+        qe_free(&os->sources[n].matches);
+    }
+    qe_free(&os->sources);
+}
+
 static const CmdDef isearch_commands[] = {
     CMD2( "isearch-abort", "C-g",
           "abort isearch and move point to starting point",
@@ -1109,6 +2211,9 @@ static const CmdDef isearch_commands[] = {
     CMD2( "isearch-toggle-case-fold", "M-c, C-c",
           "toggle search case-sensitivity",
            isearch_toggle_case_fold, ISS, "")
+    CMD2( "isearch-toggle-accent-fold", "M-'",
+          "toggle accent insensitive searching",
+           isearch_toggle_accent_fold, ISS, "")
     CMD2( "isearch-toggle-hex", "M-C-b",
           "toggle normal/hex/unihex searching",
            isearch_toggle_hex, ISS, "")
@@ -1186,6 +2291,34 @@ static const CmdDef search_commands[] = {
           "s{Replace String: }|search|"
           "s{With: }|replace|"
           "p")
+    CMD2( "occur", "M-s o",
+          "List the lines of the current buffer matching a string",
+          do_occur, ESs,
+          "s{List lines matching: }|search|")
+    CMD2( "multi-occur", "",
+          "List the lines matching a string in several buffers",
+          do_multi_occur, ESss,
+          "s{List lines matching: }|search|"
+          "s{In buffers (default all): }|buffer|")
+};
+
+static const CmdDef occur_commands[] = {
+    CMD1( "occur-goto", "RET, LF, e",
+          "Go to the match on the current line",
+          occur_goto, 0)
+    CMD1( "occur-display", "C-o, SPC",
+          "Display the match on the current line in another window",
+          occur_goto, 1)
+    CMD0( "occur-refresh", "g",
+          "Search the source buffers again",
+          occur_refresh)
+};
+
+/* additional mode specific bindings */
+static const char * const occur_bindings[] = {
+    "n", "next-line",
+    "p", "previous-line",
+    NULL
 };
 
 static ModeDef isearch_mode = {
@@ -1197,6 +2330,18 @@ static int search_init(void) {
     qe_register_mode(&isearch_mode, MODEF_NOCMD);
     qe_register_commands(&isearch_mode, isearch_commands, countof(isearch_commands));
     qe_register_commands(NULL, search_commands, countof(search_commands));
+
+    /* inherit from list mode */
+    memcpy(&occur_mode, &list_mode, sizeof(ModeDef));
+    occur_mode.name = "occur";
+    occur_mode.mode_probe = occur_mode_probe;
+    occur_mode.buffer_instance_size = sizeof(OccurState);
+    occur_mode.mode_init = occur_mode_init;
+    occur_mode.mode_free = occur_mode_free;
+    occur_mode.display_hook = occur_display_hook;
+    occur_mode.bindings = occur_bindings;
+    qe_register_mode(&occur_mode, MODEF_VIEW);
+    qe_register_commands(&occur_mode, occur_commands, countof(occur_commands));
     return 0;
 }
 
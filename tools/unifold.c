@@ -0,0 +1,204 @@
+/*
+ * Generate Unicode case folding and accent stripping tables for QEmacs
+ *
+ * Copyright (c) 2002-2022 Charlie Gordon.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cutils.h"
+
+/* Tables cover the BMP and the SMP, there are no cased letters nor
+ * decomposable characters beyond.  Each table is split in blocks of
+ * FOLD_BLOCK_SIZE code points, identical blocks are shared.
+ */
+#define FOLD_LIMIT       0x20000
+#define FOLD_SHIFT       7
+#define FOLD_BLOCK_SIZE  (1 << FOLD_SHIFT)
+#define FOLD_NB_BLOCKS   (FOLD_LIMIT >> FOLD_SHIFT)
+
+static int upper_map[FOLD_LIMIT];
+static int lower_map[FOLD_LIMIT];
+static int decomp_map[FOLD_LIMIT];  /* base character if decomposable */
+static int fold_table[FOLD_LIMIT];  /* deltas to the folded value */
+
+/* combining diacritical marks are ignored when matching accents */
+static int is_diacritic(int c)
+{
+    return (c >= 0x0300 && c <= 0x036F)
+        || (c >= 0x1AB0 && c <= 0x1AFF)
+        || (c >= 0x1DC0 && c <= 0x1DFF)
+        || (c >= 0x20D0 && c <= 0x20FF)
+        || (c >= 0xFE20 && c <= 0xFE2F);
+}
+
+/* Get a semicolon separated field from a UnicodeData.txt line */
+static const char *get_field(const char *p, int n)
+{
+    while (n-- > 0) {
+        p = strchr(p, ';');
+        if (!p)
+            return "";
+        p++;
+    }
+    return p;
+}
+
+static void load_unicode_data(FILE *f, const char *filename)
+{
+    char line[1024];
+    const char *p;
+    int c, c1, base, nb_lines = 0;
+
+    while (fgets(line, sizeof(line), f)) {
+        nb_lines++;
+        c = strtol_c(line, &p, 16);
+        if (*p != ';' || c < 0 || c >= FOLD_LIMIT)
+            continue;
+        p = get_field(line, 12);
+        if (*p != ';' && *p != '\0')
+            upper_map[c] = strtol_c(p, NULL, 16);
+        p = get_field(line, 13);
+        if (*p != ';' && *p != '\0')
+            lower_map[c] = strtol_c(p, NULL, 16);
+        /* only use canonical decompositions into a base character
+           followed by diacritics */
+        p = get_field(line, 5);
+        if (*p == '<' || *p == ';')
+            continue;
+        base = strtol_c(p, &p, 16);
+        while (*p == ' ') {
+            c1 = strtol_c(p, &p, 16);
+            if (!is_diacritic(c1)) {
+                base = 0;
+                break;
+            }
+        }
+        if (base > 0 && base < FOLD_LIMIT)
+            decomp_map[c] = base;
+    }
+    if (nb_lines == 0) {
+        fprintf(stderr, "%s: empty file\n", filename);
+        exit(1);
+    }
+}
+
+static int fold_case(int c)
+{
+    /* fold to the lower case of the upper case to unify variants
+       such as final sigma, long s and title case letters */
+    if (upper_map[c])
+        c = upper_map[c];
+    if (lower_map[c])
+        c = lower_map[c];
+    return c;
+}
+
+static int fold_accent(int c)
+{
+    if (is_diacritic(c))
+        return 0;
+    while (decomp_map[c])
+        c = decomp_map[c];
+    return c;
+}
+
+static void dump_table(const char *name, const char *comment)
+{
+    int index[FOLD_NB_BLOCKS];
+    int blocks[FOLD_NB_BLOCKS];
+    int i, j, k, n, nb_blocks = 0;
+
+    for (i = 0; i < FOLD_NB_BLOCKS; i++) {
+        const int *p = fold_table + (i << FOLD_SHIFT);
+        for (k = 0; k < nb_blocks; k++) {
+            if (!memcmp(p, fold_table + (blocks[k] << FOLD_SHIFT),
+                        FOLD_BLOCK_SIZE * sizeof(*p)))
+                break;
+        }
+        if (k == nb_blocks)
+            blocks[nb_blocks++] = i;
+        index[i] = k;
+    }
+    if (nb_blocks > 256) {
+        fprintf(stderr, "%s: too many blocks\n", name);
+        exit(1);
+    }
+
+    printf("\n/* %s */\n", comment);
+    printf("static unsigned char const %s_index[%d] = {\n",
+           name, FOLD_NB_BLOCKS);
+    for (i = 0; i < FOLD_NB_BLOCKS; i++) {
+        if ((i & 15) == 0)
+            printf("   ");
+        printf(" %3d,", index[i]);
+        if ((i & 15) == 15)
+            printf("\n");
+    }
+    printf("};\n");
+
+    printf("\nstatic int const %s[%d][%d] = {\n",
+           name, nb_blocks, FOLD_BLOCK_SIZE);
+    for (k = 0; k < nb_blocks; k++) {
+        const int *p = fold_table + (blocks[k] << FOLD_SHIFT);
+        printf("    {   /* %05X */\n", blocks[k] << FOLD_SHIFT);
+        for (j = 0; j < FOLD_BLOCK_SIZE; j += 8) {
+            printf("       ");
+            for (n = 0; n < 8; n++)
+                printf(" %d,", p[j + n]);
+            printf("\n");
+        }
+        printf("    },\n");
+    }
+    printf("};\n");
+}
+
+int main(int argc, char **argv)
+{
+    const char *filename = "UnicodeData.txt";
+    FILE *f;
+    int c;
+
+    if (argc > 1)
+        filename = argv[1];
+
+    f = fopen(filename, "r");
+    if (!f) {
+        perror(filename);
+        exit(1);
+    }
+    load_unicode_data(f, filename);
+    fclose(f);
+
+    printf("/* This file was generated automatically by unifold from %s */\n",
+           get_basename(filename));
+    printf("\n#define UNICODE_FOLD_LIMIT  0x%X\n", FOLD_LIMIT);
+    printf("#define UNICODE_FOLD_SHIFT  %d\n", FOLD_SHIFT);
+
+    for (c = 0; c < FOLD_LIMIT; c++)
+        fold_table[c] = fold_case(c) - c;
+    dump_table("unicode_fold_case", "simple case folding");
+
+    for (c = 0; c < FOLD_LIMIT; c++)
+        fold_table[c] = fold_accent(c) - c;
+    dump_table("unicode_fold_accent",
+               "accent stripping, diacritics fold to 0");
+
+    return 0;
+}
@@ -56,6 +56,7 @@ typedef uint64_t TTYChar;
 #define TTY_ITALIC            0x08000
 #define TTY_BLINK             0x10000
 #define COMB_CACHE_SIZE       2048
+#define COMB_HASH_SIZE        256
 #else
 typedef uint32_t TTYChar;
 /* TTY composite style has 4-bit BG color, 4 attribute bits and 8-bit FG color */
@@ -79,6 +80,7 @@ typedef uint32_t TTYChar;
 #define TTY_ITALIC            0x0400
 #define TTY_BLINK             0x0800
 #define COMB_CACHE_SIZE       1
+#define COMB_HASH_SIZE        1
 #endif
 
 #if defined(CONFIG_UNLOCKIO)
@@ -105,8 +107,14 @@ enum InputState {
     IS_CSI,
     IS_CSI2,
     IS_ESC2,
+    IS_PASTE,   /* bracketed paste: until CSI 201 ~ */
 };
 
+/* input_private bits for terminal reports in CSI sequences */
+#define CSI_START     1     /* nothing seen yet after ESC [ */
+#define CSI_PRIVATE   2     /* '?' seen directly after ESC [ */
+#define CSI_DOLLAR    4     /* '$' seen after CSI ? */
+
 enum TermCode {
     TERM_UNKNOWN = 0,
     TERM_ANSI,
@@ -117,16 +125,32 @@ enum TermCode {
     TERM_TW100,
 };
 
+/* direct mapped cache of qe_map_color results, size must be a power of 2 */
+#define TTY_COLOR_CACHE_SIZE  256
+
+typedef struct TTYColorCacheEntry {
+    QEColor key;        /* RGB color with bit 24 set, 0 if unused */
+    int count;          /* size of the target palette */
+    unsigned int index;
+} TTYColorCacheEntry;
+
 typedef struct TTYState {
     TTYChar *screen;
     int screen_size;
     unsigned char *line_updated;
+    uint32_t *row_hash;     /* screen and shadow row hashes */
     struct termios oldtty;
     int cursor_x, cursor_y;
     /* input handling */
+    unsigned char inbuf[4096];  /* bytes read from the terminal */
+    int inbuf_pos, inbuf_len;
+    char *paste_buf;            /* bracketed paste contents */
+    int paste_len, paste_size;
+    int paste_overflow;         /* out of memory: discard until CSI 201 ~ */
     enum InputState input_state;
     int has_meta;
     int input_param, input_param2;
+    int input_private;  /* CSI_xxx bits */
     int utf8_index;
     unsigned char buf[8];
     char *term_name;
@@ -138,6 +162,12 @@ typedef struct TTYState {
 #define USE_BLINK_AS_BRIGHT_BG  0x08
 #define USE_256_COLORS          0x10
 #define USE_TRUE_COLORS         0x20
+#define USE_SYNC_UPDATE         0x40
+#define USE_SCROLL_REGION       0x80
+#define USE_ERASE_CHARS         0x100
+#define USE_REPEAT_CHAR         0x200
+#define USE_INSERT_CHARS        0x400
+#define USE_BRACKETED_PASTE     0x800
     /* number of colors supported by the actual terminal */
     const QEColor *term_colors;
     int term_fg_colors_count;
@@ -146,7 +176,34 @@ typedef struct TTYState {
     const QEColor *tty_colors;
     int tty_fg_colors_count;
     int tty_bg_colors_count;
+    const QEColor *color_cache_palette;  /* palette of the color cache */
+    TTYColorCacheEntry color_cache[TTY_COLOR_CACHE_SIZE];
+    /* combination glyphs: blocks of code points indexed by a hash
+     * table, with the count of screen cells referencing each block */
     unsigned int comb_cache[COMB_CACHE_SIZE];
+    unsigned int comb_refs[COMB_CACHE_SIZE];
+    unsigned short comb_next[COMB_CACHE_SIZE];  /* hash chain, offset + 1 */
+    unsigned short comb_hash[COMB_HASH_SIZE];   /* chain heads, offset + 1 */
+    int comb_top;       /* end of the allocated blocks */
+    int comb_used;      /* number of blocks in use */
+    int comb_dead;      /* number of blocks released since last collect */
+    /* frame output buffer, written in one call */
+    unsigned char *outbuf;
+    int outbuf_len, outbuf_size;
+    /* terminal state while composing a frame */
+    int out_x, out_y;   /* cursor position, -1 if unknown */
+    int out_fg, out_bg, out_attr;
+    int out_cursor_x, out_cursor_y; /* cursor left by the last frame */
+    /* output statistics */
+    uint64_t out_bytes;
+    int64_t out_usec;           /* total time spent in write() */
+    unsigned int out_frames;
+    unsigned int out_dropped;   /* frames skipped while output blocked */
+    int frame_bytes, frame_usec;
+    int max_frame_bytes, max_frame_usec;
+    int out_rate;               /* estimated throughput in bytes/s */
+    int out_blocked;            /* last frame blocked in write() */
+    int low_bandwidth;          /* render without colors */
 } TTYState;
 
 static QEditScreen *tty_screen;   /* for tty_term_exit and tty_term_resize */
@@ -157,6 +214,156 @@ static void tty_term_resize(int sig);
 static void tty_term_exit(void);
 static void tty_read_handler(void *opaque);
 
+/* Frame output: escape sequences and text are composed in a growable
+ * buffer and written with a single write() at the end of tty_dpy_flush.
+ */
+static void tty_out_flush(QEditScreen *s)
+{
+    TTYState *ts = s->priv_data;
+    const unsigned char *p = ts->outbuf;
+    int len = ts->outbuf_len;
+    int n;
+    int start_usec;
+
+    /* stdio output such as init strings must go first */
+    fflush(s->STDOUT);
+    start_usec = get_clock_usec();
+    ts->frame_bytes += len;
+    while (len > 0) {
+        n = write(fileno(s->STDOUT), p, len);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN) {
+                /* wait for the terminal to drain instead of spinning */
+                fd_set wfds;
+
+                FD_ZERO(&wfds);
+                FD_SET(fileno(s->STDOUT), &wfds);
+                select(fileno(s->STDOUT) + 1, NULL, &wfds, NULL, NULL);
+                continue;
+            }
+            break;
+        }
+        p += n;
+        len -= n;
+    }
+    ts->frame_usec += get_clock_usec() - start_usec;
+    ts->outbuf_len = 0;
+}
+
+static unsigned char *tty_out_reserve(QEditScreen *s, int n)
+{
+    TTYState *ts = s->priv_data;
+
+    if (ts->outbuf_len + n > ts->outbuf_size) {
+        int size = max(ts->outbuf_size + ts->outbuf_size / 2 + 4096,
+                       ts->outbuf_len + n);
+        if (!qe_realloc(&ts->outbuf, size)) {
+            /* output the partial frame and reuse the buffer */
+            tty_out_flush(s);
+            if (n > ts->outbuf_size)
+                return NULL;
+        } else {
+            ts->outbuf_size = size;
+        }
+    }
+    return ts->outbuf + ts->outbuf_len;
+}
+
+static void tty_out_write(QEditScreen *s, const void *buf, int n)
+{
+    TTYState *ts = s->priv_data;
+    unsigned char *q = tty_out_reserve(s, n);
+
+    if (q) {
+        memcpy(q, buf, n);
+        ts->outbuf_len += n;
+    }
+}
+
+static inline void tty_out_putc(QEditScreen *s, int c)
+{
+    TTYState *ts = s->priv_data;
+
+    if (ts->outbuf_len < ts->outbuf_size || tty_out_reserve(s, 1))
+        ts->outbuf[ts->outbuf_len++] = c;
+}
+
+static void tty_out_puts(QEditScreen *s, const char *str)
+{
+    tty_out_write(s, str, strlen(str));
+}
+
+static void tty_out_num(QEditScreen *s, unsigned int n)
+{
+    char buf[16];
+    int i = sizeof(buf);
+
+    do {
+        buf[--i] = '0' + n % 10;
+        n /= 10;
+    } while (n);
+    tty_out_write(s, buf + i, sizeof(buf) - i);
+}
+
+/* CSI n c */
+static void tty_out_csi(QEditScreen *s, int n, int c)
+{
+    tty_out_write(s, "\033[", 2);
+    tty_out_num(s, n);
+    tty_out_putc(s, c);
+}
+
+/* CSI n1 ; n2 c */
+static void tty_out_csi2(QEditScreen *s, int n1, int n2, int c)
+{
+    tty_out_write(s, "\033[", 2);
+    tty_out_num(s, n1);
+    tty_out_putc(s, ';');
+    tty_out_num(s, n2);
+    tty_out_putc(s, c);
+}
+
+/* Map an RGB color to the virtual tty palette.  Results are cached
+ * because the same few colors are mapped for every call of
+ * tty_dpy_fill_rectangle and tty_dpy_draw_text.
+ */
+static unsigned int tty_map_color(TTYState *ts, QEColor color, int count)
+{
+    TTYColorCacheEntry *cp;
+    QEColor key;
+
+    if (count >= 0x1000000)
+        return qe_map_color(color, ts->tty_colors, count, NULL);
+
+    if (ts->color_cache_palette != ts->tty_colors) {
+        /* palette changed: invalidate the cache */
+        memset(ts->color_cache, 0, sizeof(ts->color_cache));
+        ts->color_cache_palette = ts->tty_colors;
+    }
+    key = (color & 0xFFFFFF) | 0x1000000;
+    cp = &ts->color_cache[((key * 0x9E3779B1) >> 24 ^ count) &
+                          (TTY_COLOR_CACHE_SIZE - 1)];
+    if (cp->key != key || cp->count != count) {
+        cp->key = key;
+        cp->count = count;
+        cp->index = qe_map_color(color, ts->tty_colors, count, NULL);
+    }
+    return cp->index;
+}
+
+/* Precompute the mappings of the style colors */
+static void tty_map_style_colors(TTYState *ts)
+{
+    int i;
+
+    for (i = 0; i < QE_STYLE_NB; i++) {
+        tty_map_color(ts, qe_styles[i].fg_color, ts->tty_fg_colors_count);
+        tty_map_color(ts, qe_styles[i].bg_color, ts->tty_bg_colors_count);
+    }
+}
+
 static int tty_dpy_probe(void)
 {
     return 1;
@@ -203,9 +410,23 @@ static int tty_dpy_init(QEditScreen *s,
         } else
         if (strstart(ts->term_name, "xterm", NULL)) {
             ts->term_code = TERM_XTERM;
+            ts->term_flags |= USE_SCROLL_REGION | USE_ERASE_CHARS |
+                              USE_INSERT_CHARS | USE_BRACKETED_PASTE;
+            /* REP is not supported by all xterm clones */
+            if (getenv("XTERM_VERSION") || getenv("VTE_VERSION")
+            ||  ((p = getenv("TERM_PROGRAM")) && strequal(p, "iTerm.app"))) {
+                ts->term_flags |= USE_REPEAT_CHAR;
+            }
         } else
         if (strstart(ts->term_name, "linux", NULL)) {
             ts->term_code = TERM_LINUX;
+            ts->term_flags |= USE_SCROLL_REGION | USE_ERASE_CHARS |
+                              USE_INSERT_CHARS | USE_BRACKETED_PASTE;
+        } else
+        if (strstart(ts->term_name, "screen", NULL)
+        ||  strstart(ts->term_name, "tmux", NULL)) {
+            ts->term_flags |= USE_SCROLL_REGION | USE_ERASE_CHARS |
+                              USE_INSERT_CHARS | USE_BRACKETED_PASTE;
         } else
         if (strstart(ts->term_name, "cygwin", NULL)) {
             ts->term_code = TERM_CYGWIN;
@@ -350,6 +571,17 @@ static int tty_dpy_init(QEditScreen *s,
     }
     put_status(NULL, "tty charset: %s", s->charset->name);
 
+    if (ts->term_flags & USE_BRACKETED_PASTE) {
+        /* pasted text is sent between CSI 200 ~ and CSI 201 ~ */
+        TTY_FPUTS("\033[?2004h", s->STDOUT);
+    }
+
+    if (ts->term_code == TERM_XTERM) {
+        /* query synchronized output support (DEC mode 2026), the reply
+           is handled by tty_read_handler */
+        TTY_FPUTS("\033[?2026$p", s->STDOUT);
+    }
+
     atexit(tty_term_exit);
 
     sig.sa_handler = tty_term_resize;
@@ -387,6 +619,8 @@ static void tty_dpy_close(QEditScreen *s)
 #else
     /* go to last line and clear it */
     TTY_FPRINTF(s->STDOUT, "\033[%d;%dH" "\033[m\033[K", s->height, 1);
+    if (ts->term_flags & USE_BRACKETED_PASTE)
+        TTY_FPUTS("\033[?2004l", s->STDOUT);
     TTY_FPRINTF(s->STDOUT,
                 "\033[?1049l"       /* exit_ca_mode */
                 "\033[?1l\033>"     /* keypad_local */
@@ -398,6 +632,9 @@ static void tty_dpy_close(QEditScreen *s)
 
     qe_free(&ts->screen);
     qe_free(&ts->line_updated);
+    qe_free(&ts->row_hash);
+    qe_free(&ts->outbuf);
+    qe_free(&ts->paste_buf);
 }
 
 static void tty_term_exit(void)
@@ -425,6 +662,206 @@ static void tty_term_resize(qe__unused__ int sig)
     }
 }
 
+#if MAX_UNICODE_DISPLAY > 0xFFFF
+
+#define TTY_CHAR_IS_COMB(ch) \
+    ((ch) >= TTY_CHAR_COMB && (ch) < TTY_CHAR_COMB + COMB_CACHE_SIZE - 1)
+
+static unsigned int comb_cache_hash(const unsigned int *seq, int len) {
+    unsigned int h = len;
+
+    while (len-- > 0) {
+        h = h * 31 + *seq++;
+    }
+    return (h ^ (h >> 11)) & (COMB_HASH_SIZE - 1);
+}
+
+static void comb_cache_reset(TTYState *ts) {
+    ts->comb_cache[0] = 0;
+    ts->comb_top = 0;
+    ts->comb_used = 0;
+    ts->comb_dead = 0;
+    memset(ts->comb_hash, 0, sizeof(ts->comb_hash));
+}
+
+/* Allocate a block for len code points, return its offset or -1 */
+static int comb_cache_alloc(TTYState *ts, int len) {
+    unsigned int *ip;
+
+    if (ts->comb_top + len + 1 < countof(ts->comb_cache)) {
+        ip = ts->comb_cache + ts->comb_top;
+        ts->comb_top += len + 1;
+        ts->comb_cache[ts->comb_top] = 0;
+        return ip - ts->comb_cache;
+    }
+    /* first fit in the free blocks */
+    for (ip = ts->comb_cache; *ip; ip += *ip & 0xFFFF) {
+        if (*ip >= 0x10001U + len) {
+            if (*ip > 0x10001U + len) {
+                /* split free block */
+                ip[len + 1] = *ip - (len + 1);
+            }
+            return ip - ts->comb_cache;
+        }
+    }
+    return -1;
+}
+
+/* Get the glyph code for a combination, with a new reference */
+static unsigned int comb_cache_add(TTYState *ts, const unsigned int *seq, int len) {
+    unsigned int h = comb_cache_hash(seq, len);
+    unsigned int *ip;
+    int off;
+
+    for (off = ts->comb_hash[h] - 1; off >= 0; off = ts->comb_next[off] - 1) {
+        ip = ts->comb_cache + off;
+        if (*ip == len + 1U && !memcmp(ip + 1, seq, len * sizeof(*ip))) {
+            ts->comb_refs[off]++;
+            return TTY_CHAR_COMB + off;
+        }
+    }
+    off = comb_cache_alloc(ts, len);
+    if (off < 0)
+        return TTY_CHAR_BAD;
+    ip = ts->comb_cache + off;
+    *ip = len + 1;
+    memcpy(ip + 1, seq, len * sizeof(*ip));
+    ts->comb_refs[off] = 1;
+    ts->comb_next[off] = ts->comb_hash[h];
+    ts->comb_hash[h] = off + 1;
+    ts->comb_used++;
+    return TTY_CHAR_COMB + off;
+}
+
+static inline void comb_cache_ref(TTYState *ts, TTYChar cc) {
+    unsigned int ch = TTY_CHAR_GET_CH(cc);
+
+    if (TTY_CHAR_IS_COMB(ch))
+        ts->comb_refs[ch - TTY_CHAR_COMB]++;
+}
+
+/* Release the combination glyphs of n screen cells about to be
+ * overwritten.  Unreferenced blocks are only freed by
+ * comb_cache_collect() after the next flush, because the shadow
+ * buffer may still use their codes until then.
+ */
+static inline void comb_cache_release(TTYState *ts, const TTYChar *ptr, int n) {
+    unsigned int ch;
+
+    if (ts->comb_used == 0)
+        return;
+
+    for (; n-- > 0; ptr++) {
+        ch = TTY_CHAR_GET_CH(*ptr);
+        if (TTY_CHAR_IS_COMB(ch)
+        &&  ts->comb_refs[ch - TTY_CHAR_COMB]
+        &&  --ts->comb_refs[ch - TTY_CHAR_COMB] == 0) {
+            ts->comb_dead++;
+        }
+    }
+}
+
+/* Free the unreferenced blocks, once the screen has been flushed */
+static void comb_cache_collect(TTYState *ts) {
+    unsigned int *ip;
+    unsigned short *pp;
+    int off;
+
+    if (ts->comb_dead == 0)
+        return;
+    ts->comb_dead = 0;
+
+    for (ip = ts->comb_cache; *ip != 0; ip += *ip & 0xFFFF) {
+        off = ip - ts->comb_cache;
+        if (!(*ip & 0x10000) && ts->comb_refs[off] == 0) {
+            /* unlink from hash chain */
+            pp = &ts->comb_hash[comb_cache_hash(ip + 1, *ip - 1)];
+            while (*pp != off + 1) {
+                pp = &ts->comb_next[*pp - 1];
+            }
+            *pp = ts->comb_next[off];
+            *ip |= 0x10000;
+            ts->comb_used--;
+        }
+    }
+    for (ip = ts->comb_cache; *ip != 0; ip += *ip & 0xFFFF) {
+        if (*ip & 0x10000) {
+            while (ip[*ip & 0xFFFF] & 0x10000) {
+                /* coalesce subsequent free blocks */
+                *ip += ip[*ip & 0xFFFF] & 0xFFFF;
+            }
+            if (ip[*ip & 0xFFFF] == 0) {
+                /* truncate free list */
+                *ip = 0;
+                ts->comb_top = ip - ts->comb_cache;
+                break;
+            }
+        }
+    }
+}
+
+static void comb_cache_describe(QEditScreen *s, EditBuffer *b) {
+    TTYState *ts = s->priv_data;
+    unsigned int *ip;
+    unsigned int i;
+    int w = 16;
+
+    eb_printf(b, "Device Description\n\n");
+
+    eb_printf(b, "%*s: %s\n", w, "term_name", ts->term_name);
+    eb_printf(b, "%*s: %d  %s\n", w, "term_code", ts->term_code,
+              ts->term_code == TERM_UNKNOWN ? "UNKNOWN" :
+              ts->term_code == TERM_ANSI ? "ANSI" :
+              ts->term_code == TERM_VT100 ? "VT100" :
+              ts->term_code == TERM_XTERM ? "XTERM" :
+              ts->term_code == TERM_LINUX ? "LINUX" :
+              ts->term_code == TERM_CYGWIN ? "CYGWIN" :
+              ts->term_code == TERM_TW100 ? "TW100" :
+              "");
+    eb_printf(b, "%*s: %#x %s%s%s%s%s%s%s%s%s%s%s%s\n", w, "term_flags", ts->term_flags,
+              ts->term_flags & KBS_CONTROL_H ? " KBS_CONTROL_H" : "",
+              ts->term_flags & USE_ERASE_END_OF_LINE ? " USE_ERASE_END_OF_LINE" : "",
+              ts->term_flags & USE_BOLD_AS_BRIGHT_FG ? " USE_BOLD_AS_BRIGHT_FG" : "",
+              ts->term_flags & USE_BLINK_AS_BRIGHT_BG ? " USE_BLINK_AS_BRIGHT_BG" : "",
+              ts->term_flags & USE_256_COLORS ? " USE_256_COLORS" : "",
+              ts->term_flags & USE_TRUE_COLORS ? " USE_TRUE_COLORS" : "",
+              ts->term_flags & USE_SYNC_UPDATE ? " USE_SYNC_UPDATE" : "",
+              ts->term_flags & USE_SCROLL_REGION ? " USE_SCROLL_REGION" : "",
+              ts->term_flags & USE_ERASE_CHARS ? " USE_ERASE_CHARS" : "",
+              ts->term_flags & USE_REPEAT_CHAR ? " USE_REPEAT_CHAR" : "",
+              ts->term_flags & USE_INSERT_CHARS ? " USE_INSERT_CHARS" : "",
+              ts->term_flags & USE_BRACKETED_PASTE ? " USE_BRACKETED_PASTE" : "");
+    eb_printf(b, "%*s: fg:%d, bg:%d\n", w, "terminal colors",
+              ts->term_fg_colors_count, ts->term_bg_colors_count);
+    eb_printf(b, "%*s: fg:%d, bg:%d\n", w, "virtual tty colors",
+              ts->tty_fg_colors_count, ts->tty_bg_colors_count);
+
+    eb_printf(b, "\nUnicode combination cache: %d used, %d/%d words\n\n",
+              ts->comb_used, ts->comb_top, COMB_CACHE_SIZE);
+
+    for (ip = ts->comb_cache; *ip != 0; ip += *ip & 0xFFFF) {
+        if (*ip & 0x10000) {
+            eb_printf(b, "   FREE   %d\n", (*ip & 0xFFFF) - 1);
+        } else {
+            eb_printf(b, "  %06X  %d:",
+                      (unsigned int)(TTY_CHAR_COMB + (ip - ts->comb_cache)),
+                      (*ip & 0xFFFF) - 1);
+            for (i = 1; i < (*ip & 0xFFFF); i++) {
+                eb_printf(b, " %04X", ip[i]);
+            }
+            eb_putc(b, '\n');
+        }
+    }
+}
+#else
+#define comb_cache_add(s, p, n)  TTY_CHAR_BAD
+#define comb_cache_reset(s)
+#define comb_cache_ref(s, cc)
+#define comb_cache_release(s, p, n)
+#define comb_cache_collect(s)
+#define comb_cache_describe(s, b)
+#endif
+
 static void tty_dpy_invalidate(QEditScreen *s)
 {
     TTYState *ts;
@@ -464,10 +901,12 @@ static void tty_dpy_invalidate(QEditScreen *s)
     /* screen buffer + shadow buffer + extra slot for loop guard */
     qe_realloc(&ts->screen, size * 2 + sizeof(TTYChar));
     qe_realloc(&ts->line_updated, s->height);
+    qe_realloc(&ts->row_hash, 2 * s->height * sizeof(*ts->row_hash));
     ts->screen_size = count;
 
     /* Erase shadow buffer to impossible value */
     memset(ts->screen + count, 0xFF, size + sizeof(TTYChar));
+    comb_cache_reset(ts);
     /* Fill screen buffer with black spaces */
     tc = TTY_CHAR_DEFAULT;
     for (i = 0; i < count; i++) {
@@ -476,6 +915,9 @@ static void tty_dpy_invalidate(QEditScreen *s)
     /* All rows need refresh */
     memset(ts->line_updated, 1, s->height);
 
+    /* styles may have changed since the last full redisplay */
+    tty_map_style_colors(ts);
+
     s->clip_x1 = 0;
     s->clip_y1 = 0;
     s->clip_x2 = s->width;
@@ -492,9 +934,14 @@ static void tty_dpy_cursor_at(QEditScreen *s, int x1, int y1,
 
 static int tty_dpy_is_user_input_pending(QEditScreen *s)
 {
+    TTYState *ts = s->priv_data;
     fd_set rfds;
     struct timeval tv;
 
+    /* bytes already read but not yet parsed */
+    if (ts->inbuf_pos < ts->inbuf_len)
+        return 1;
+
     tv.tv_sec = 0;
     tv.tv_usec = 0;
     FD_ZERO(&rfds);
@@ -543,22 +990,152 @@ static int const csi_lookup[] = {
     KEY_F20,      /* 34 */
 };
 
+/* Deliver the bracketed paste contents as a single paste event */
+static void tty_paste_flush(QEditScreen *s)
+{
+    TTYState *ts = s->priv_data;
+    QEEvent ev1, *ev = &ev1;
+    char *p = ts->paste_buf, *end = p + ts->paste_len;
+    char *q, *text = NULL;
+    int c;
+
+    /* terminals send newlines as CR */
+    for (q = p; p < end; p++) {
+        if (*p == '\r') {
+            if (p + 1 < end && p[1] == '\n')
+                continue;
+            *q++ = '\n';
+        } else {
+            *q++ = *p;
+        }
+    }
+    p = ts->paste_buf;
+    end = q;
+    if (s->charset != &charset_utf8) {
+        /* other tty charsets are handled as latin1, as for keys */
+        text = qe_malloc_array(char, (end - p) * 2);
+        if (!text)
+            return;
+        for (q = text; p < end; p++) {
+            c = (u8)*p;
+            q += utf8_encode(q, c);
+        }
+        p = text;
+        end = q;
+    }
+    ev->paste_event.type = QE_PASTE_EVENT;
+    ev->paste_event.text = p;
+    ev->paste_event.len = end - p;
+    qe_handle_event(ev);
+    qe_free(&text);
+}
+
+/* Accumulate bracketed paste input up to the CSI 201 ~ terminator */
+static void tty_paste_input(QEditScreen *s)
+{
+    TTYState *ts = s->priv_data;
+    static const char paste_end[] = "\033[201~";
+    int n = ts->inbuf_len - ts->inbuf_pos;
+    int start = max(0, ts->paste_len - (int)sizeof(paste_end) + 2);
+    char *p, *end;
+    int k;
+
+    if (!ts->paste_overflow && ts->paste_len + n > ts->paste_size) {
+        int size = max(ts->paste_size * 2, ts->paste_len + n);
+        if (!qe_realloc(&ts->paste_buf, size)) {
+            /* drop the pasted text, paste_len becomes the length of
+               the terminator prefix matched so far */
+            for (k = min(ts->paste_len, (int)sizeof(paste_end) - 2);
+                 k > 0; k--) {
+                if (!memcmp(ts->paste_buf + ts->paste_len - k, paste_end, k))
+                    break;
+            }
+            ts->paste_len = k;
+            ts->paste_overflow = 1;
+        } else {
+            ts->paste_size = size;
+        }
+    }
+    if (ts->paste_overflow) {
+        while (ts->inbuf_pos < ts->inbuf_len) {
+            int c = ts->inbuf[ts->inbuf_pos++];
+            if (c == paste_end[ts->paste_len])
+                ts->paste_len++;
+            else
+                ts->paste_len = (c == '\033');
+            if (ts->paste_len == sizeof(paste_end) - 1) {
+                ts->paste_len = 0;
+                ts->paste_overflow = 0;
+                ts->input_state = IS_NORM;
+                return;
+            }
+        }
+        return;
+    }
+    memcpy(ts->paste_buf + ts->paste_len, ts->inbuf + ts->inbuf_pos, n);
+    ts->paste_len += n;
+    ts->inbuf_pos = ts->inbuf_len;
+
+    end = ts->paste_buf + ts->paste_len - (sizeof(paste_end) - 1);
+    for (p = ts->paste_buf + start;
+         (p = memchr(p, '\033', ts->paste_buf + ts->paste_len - p)) != NULL
+         && p <= end; p++) {
+        if (!memcmp(p, paste_end, sizeof(paste_end) - 1)) {
+            /* give back the bytes following the terminator */
+            ts->inbuf_pos -= end - p;
+            ts->paste_len = p - ts->paste_buf;
+            ts->input_state = IS_NORM;
+            tty_paste_flush(s);
+            ts->paste_len = 0;
+            return;
+        }
+    }
+}
+
+static void tty_input_byte(QEditScreen *s, int ch);
+
+/* Read input in blocks and parse it from the input buffer */
 static void tty_read_handler(void *opaque)
 {
     QEditScreen *s = opaque;
     QEmacsState *qs = &qe_state;
     TTYState *ts = s->priv_data;
-    QEEvent ev1, *ev = &ev1;
-    u8 buf[1];
-    int ch, len, n1;
+    int n;
 
-    if (read(fileno(s->STDIN), buf, 1) != 1)
+    if (ts->inbuf_pos == ts->inbuf_len) {
+        ts->inbuf_pos = ts->inbuf_len = 0;
+    } else
+    if (ts->inbuf_len == countof(ts->inbuf)) {
+        /* recursive call: compact the buffer */
+        ts->inbuf_len -= ts->inbuf_pos;
+        memmove(ts->inbuf, ts->inbuf + ts->inbuf_pos, ts->inbuf_len);
+        ts->inbuf_pos = 0;
+    }
+    n = read(fileno(s->STDIN), ts->inbuf + ts->inbuf_len,
+             countof(ts->inbuf) - ts->inbuf_len);
+    if (n <= 0)
         return;
 
     if (qs->trace_buffer)
-        eb_trace_bytes(buf, 1, EB_TRACE_TTY);
+        eb_trace_bytes(ts->inbuf + ts->inbuf_len, n, EB_TRACE_TTY);
+
+    ts->inbuf_len += n;
+    while (ts->inbuf_pos < ts->inbuf_len) {
+        if (ts->input_state == IS_PASTE) {
+            tty_paste_input(s);
+        } else {
+            tty_input_byte(s, ts->inbuf[ts->inbuf_pos++]);
+        }
+    }
+}
+
+static void tty_input_byte(QEditScreen *s, int ch)
+{
+    QEmacsState *qs = &qe_state;
+    TTYState *ts = s->priv_data;
+    QEEvent ev1, *ev = &ev1;
+    int len, n1;
 
-    ch = buf[0];
     /* keep TTY bytes for error messages */
     if (qs->input_len < countof(qs->input_buf))
         qs->input_buf[qs->input_len++] = ch;
@@ -620,6 +1197,7 @@ static void tty_read_handler(void *opaque)
             ts->input_state = IS_CSI;
             ts->input_param = 0;
             ts->input_param2 = 0;
+            ts->input_private = CSI_START;
         } else if (ch == 'O') {
             ts->input_state = IS_ESC2;
             ts->input_param = 0;
@@ -633,9 +1211,23 @@ static void tty_read_handler(void *opaque)
     case IS_CSI:
         if (ch >= '0' && ch <= '9') {
             ts->input_param = ts->input_param * 10 + ch - '0';
+            ts->input_private &= ~CSI_START;
             break;
         }
         ts->input_state = IS_NORM;
+        if (ts->input_private & CSI_DOLLAR) {
+            if (ch == 'y') {
+                /* DECRPM: CSI ? mode ; value $ y */
+                if (ts->input_param2 == 2026
+                &&  ts->input_param >= 1 && ts->input_param <= 3) {
+                    ts->term_flags |= USE_SYNC_UPDATE;
+                }
+                break;
+            }
+            ch = KEY_UNKNOWN;
+            ts->has_meta = 0;
+            goto the_end;
+        }
         switch (ch) {
         case ';': /* multi ignore but the last 2 */
             /* iterm2 uses this for some keys:
@@ -643,15 +1235,38 @@ static void tty_read_handler(void *opaque)
              */
             ts->input_param2 = ts->input_param;
             ts->input_param = 0;
+            ts->input_private &= ~CSI_START;
             ts->input_state = IS_CSI;
             break;
         case '[':
             ts->input_state = IS_CSI2;
             break;
+        case '?':
+            /* terminal reports: CSI ? ... */
+            if (ts->input_private & CSI_START) {
+                ts->input_private = CSI_PRIVATE;
+                ts->input_state = IS_CSI;
+                break;
+            }
+            goto csi_default;
+        case '$':
+            /* rxvt uses CSI 2 $ and CSI 3 $ for S-insert and S-delete */
+            if (ts->input_private & CSI_PRIVATE) {
+                ts->input_private |= CSI_DOLLAR;
+                ts->input_state = IS_CSI;
+                break;
+            }
+            goto csi_default;
         case '~':
             /* If there is a second param, it tells the shift state,
              * ex: S-f5 = ^[[15;2~ */
             n1 = ts->input_param;
+            if (n1 == 200 && !ts->input_param2) {
+                /* start of bracketed paste */
+                ts->input_state = IS_PASTE;
+                ts->paste_len = 0;
+                break;
+            }
             if (ts->input_param2) {
                 // XXX: should handle shift function keys
                 ch = KEY_UNKNOWN;
@@ -665,6 +1280,7 @@ static void tty_read_handler(void *opaque)
             break;
             /* All these for ansi|cygwin */
         default:
+        csi_default:
             /* input_param contains the shift status:
              * bit 2 is SHIFT
              * bit 4 is CTRL
@@ -759,6 +1375,10 @@ static void tty_read_handler(void *opaque)
         ch = KEY_UNKNOWN;
         goto the_end;
 
+    case IS_PASTE:
+        /* handled by tty_paste_input */
+        break;
+
     case IS_ESC2:       // "\EO"
         /* xterm/vt100 fn */
         ts->input_state = IS_NORM;
@@ -808,9 +1428,16 @@ static void tty_dpy_fill_rectangle(QEditScreen *s,
     unsigned int bgcolor;
 
     ptr = ts->screen + y1 * s->width + x1;
-    bgcolor = qe_map_color(color, ts->tty_colors, ts->tty_bg_colors_count, NULL);
+    bgcolor = tty_map_color(ts, color, ts->tty_bg_colors_count);
+    if (ts->low_bandwidth) {
+        /* only distinguish highlighted areas from the default background */
+        QEColor default_bg = qe_styles[QE_STYLE_DEFAULT].bg_color;
+        bgcolor = (tty_map_color(ts, color, 16) ==
+                   tty_map_color(ts, default_bg, 16)) ? 0 : 7;
+    }
     for (y = y1; y < y2; y++) {
         ts->line_updated[y] = 1;
+        comb_cache_release(ts, ptr, w);
         for (x = x1; x < x2; x++) {
             *ptr = TTY_CHAR(' ', 7, bgcolor);
             ptr++;
@@ -886,120 +1513,6 @@ static void tty_dpy_text_metrics(QEditScreen *s, QEFont *font,
     metrics->width = x;
 }
 
-#if MAX_UNICODE_DISPLAY > 0xFFFF
-
-static unsigned int comb_cache_add(TTYState *ts, const unsigned int *seq, int len) {
-    unsigned int *ip;
-    for (ip = ts->comb_cache; *ip; ip += *ip & 0xFFFF) {
-        if (*ip == len + 1U && !memcmp(ip + 1, seq, len * sizeof(*ip))) {
-            return TTY_CHAR_COMB + (ip - ts->comb_cache);
-        }
-    }
-    for (ip = ts->comb_cache; *ip; ip += *ip & 0xFFFF) {
-        if (*ip >= 0x10001U + len) {
-            /* found free slot */
-            if (*ip > 0x10001U + len) {
-                /* split free block */
-                ip[len + 1] = *ip - (len + 1);
-            }
-            break;
-        }
-    }
-    if (*ip == 0) {
-        if ((ip - ts->comb_cache) + len + 1 >= countof(ts->comb_cache)) {
-            return TTY_CHAR_BAD;
-        }
-        ip[len + 1] = 0;
-    }
-    *ip = len + 1;
-    memcpy(ip + 1, seq, len * sizeof(*ip));
-    return TTY_CHAR_COMB + (ip - ts->comb_cache);
-}
-
-static void comb_cache_clean(TTYState *ts, const TTYChar *screen, int len) {
-    unsigned int *ip;
-    int i;
-
-    if (ts->comb_cache[0] == 0)
-        return;
-
-    for (ip = ts->comb_cache; *ip != 0; ip += *ip & 0xFFFF) {
-        *ip |= 0x10000;
-    }
-    ip = ts->comb_cache;
-    for (i = 0; i < len; i++) {
-        int ch = TTY_CHAR_GET_CH(screen[i]);
-        if (ch >= TTY_CHAR_COMB && ch < TTY_CHAR_COMB + countof(ts->comb_cache) - 1) {
-            ip[ch - TTY_CHAR_COMB] &= ~0x10000;
-        }
-    }
-    for (; *ip != 0; ip += *ip & 0xFFFF) {
-        if (*ip & 0x10000) {
-            while (ip[*ip & 0xFFFF] & 0x10000) {
-                /* coalesce subsequent free blocks */
-                *ip += ip[*ip & 0xFFFF] & 0xFFFF;
-            }
-            if (ip[*ip & 0xFFFF] == 0) {
-                /* truncate free list */
-                *ip = 0;
-                break;
-            }
-        }
-    }
-}
-
-static void comb_cache_describe(QEditScreen *s, EditBuffer *b) {
-    TTYState *ts = s->priv_data;
-    unsigned int *ip;
-    unsigned int i;
-    int w = 16;
-
-    eb_printf(b, "Device Description\n\n");
-
-    eb_printf(b, "%*s: %s\n", w, "term_name", ts->term_name);
-    eb_printf(b, "%*s: %d  %s\n", w, "term_code", ts->term_code,
-              ts->term_code == TERM_UNKNOWN ? "UNKNOWN" :
-              ts->term_code == TERM_ANSI ? "ANSI" :
-              ts->term_code == TERM_VT100 ? "VT100" :
-              ts->term_code == TERM_XTERM ? "XTERM" :
-              ts->term_code == TERM_LINUX ? "LINUX" :
-              ts->term_code == TERM_CYGWIN ? "CYGWIN" :
-              ts->term_code == TERM_TW100 ? "TW100" :
-              "");
-    eb_printf(b, "%*s: %#x %s%s%s%s%s%s\n", w, "term_flags", ts->term_flags,
-              ts->term_flags & KBS_CONTROL_H ? " KBS_CONTROL_H" : "",
-              ts->term_flags & USE_ERASE_END_OF_LINE ? " USE_ERASE_END_OF_LINE" : "",
-              ts->term_flags & USE_BOLD_AS_BRIGHT_FG ? " USE_BOLD_AS_BRIGHT_FG" : "",
-              ts->term_flags & USE_BLINK_AS_BRIGHT_BG ? " USE_BLINK_AS_BRIGHT_BG" : "",
-              ts->term_flags & USE_256_COLORS ? " USE_256_COLORS" : "",
-              ts->term_flags & USE_TRUE_COLORS ? " USE_TRUE_COLORS" : "");
-    eb_printf(b, "%*s: fg:%d, bg:%d\n", w, "terminal colors",
-              ts->term_fg_colors_count, ts->term_bg_colors_count);
-    eb_printf(b, "%*s: fg:%d, bg:%d\n", w, "virtual tty colors",
-              ts->tty_fg_colors_count, ts->tty_bg_colors_count);
-
-    eb_printf(b, "\nUnicode combination cache:\n\n");
-
-    for (ip = ts->comb_cache; *ip != 0; ip += *ip & 0xFFFF) {
-        if (*ip & 0x10000) {
-            eb_printf(b, "   FREE   %d\n", (*ip & 0xFFFF) - 1);
-        } else {
-            eb_printf(b, "  %06X  %d:",
-                      (unsigned int)(TTY_CHAR_COMB + (ip - ts->comb_cache)),
-                      (*ip & 0xFFFF) - 1);
-            for (i = 1; i < (*ip & 0xFFFF); i++) {
-                eb_printf(b, " %04X", ip[i]);
-            }
-            eb_putc(b, '\n');
-        }
-    }
-}
-#else
-#define comb_cache_add(s, p, n)  TTY_CHAR_BAD
-#define comb_cache_clean(s, p, n)
-#define comb_cache_describe(s, b)
-#endif
-
 static void tty_dpy_draw_text(QEditScreen *s, QEFont *font,
                               int x, int y, const unsigned int *str0, int len,
                               QEColor color)
@@ -1014,7 +1527,17 @@ static void tty_dpy_draw_text(QEditScreen *s, QEFont *font,
         return;
 
     ts->line_updated[y] = 1;
-    fgcolor = qe_map_color(color, ts->tty_colors, ts->tty_fg_colors_count, NULL);
+    if (ts->comb_used) {
+        /* release the combinations overwritten by the text */
+        for (w = n = 0; n < len; n++)
+            w += tty_term_glyph_width(s, str[n]);
+        n = min(x + w, s->clip_x2) - max(x, s->clip_x1);
+        if (n > 0)
+            comb_cache_release(ts, ts->screen + y * s->width + max(x, s->clip_x1), n);
+    }
+    fgcolor = tty_map_color(ts, color, ts->tty_fg_colors_count);
+    if (ts->low_bandwidth)
+        fgcolor = 7;
     if (font->style & QE_FONT_STYLE_UNDERLINE)
         fgcolor |= TTY_UNDERLINE;
     if (font->style & QE_FONT_STYLE_BOLD)
@@ -1099,36 +1622,398 @@ static void tty_dpy_set_clip(qe__unused__ QEditScreen *s,
 {
 }
 
+static uint32_t tty_row_hash(const TTYChar *p, int n)
+{
+    uint32_t h = 0;
+
+    while (n-- > 0) {
+        h = (h ^ (uint32_t)*p ^ (uint32_t)((uint64_t)*p >> 16)) * 0x01000193;
+        p++;
+    }
+    return h;
+}
+
+/* Detect a vertical shift of rows between the shadow buffer and the
+ * screen, such as a window scrolling by a few lines.  Move the rows
+ * with a scroll region and insert/delete line sequences, shift the
+ * shadow buffer accordingly and let the row diff repaint the exposed
+ * rows.
+ */
+static void tty_scroll_rows(QEditScreen *s)
+{
+    TTYState *ts = s->priv_data;
+    int w = s->width, h = s->height, shadow = ts->screen_size;
+    uint32_t *hnew = ts->row_hash, *hold = ts->row_hash + h;
+    int y, d, top, bot, gain, best_gain, best_d, best_top, best_bot;
+    int a, b, n;
+
+    for (y = 0; y < h; y++) {
+        hnew[y] = tty_row_hash(ts->screen + y * w, w);
+        hold[y] = tty_row_hash(ts->screen + shadow + y * w, w);
+    }
+
+    /* find the run of shifted rows that saves the most row updates:
+       new row y is old row y + d */
+    best_gain = 2;
+    best_d = best_top = best_bot = 0;
+    for (d = 1 - h; d < h; d++) {
+        if (d == 0)
+            continue;
+        for (top = max(0, -d); top < h && top + d < h; top = bot + 1) {
+            gain = 0;
+            for (bot = top; bot < h && bot + d < h && hnew[bot] == hold[bot + d]; bot++) {
+                if (hnew[bot] != hold[bot])
+                    gain++;
+            }
+            if (bot == top)
+                continue;
+            /* rows exposed by the scroll that did not change */
+            if (d > 0) {
+                for (y = bot; y < bot + d && y < h; y++)
+                    gain -= (hnew[y] == hold[y]);
+            } else {
+                for (y = top + d; y < top; y++)
+                    gain -= (hnew[y] == hold[y]);
+            }
+            if (gain > best_gain) {
+                best_gain = gain;
+                best_d = d;
+                best_top = top;
+                best_bot = bot;
+            }
+        }
+    }
+    if (!best_d)
+        return;
+
+    /* verify the rows to rule out hash collisions */
+    for (y = best_top; y < best_bot; y++) {
+        if (memcmp(ts->screen + y * w, ts->screen + shadow + (y + best_d) * w,
+                   w * sizeof(TTYChar)))
+            break;
+    }
+    best_bot = y;
+    if (best_bot - best_top < 3)
+        return;
+
+    /* region rows [a, b) and shadow update */
+    d = best_d;
+    if (d > 0) {
+        a = best_top;
+        b = best_bot + d;
+        n = d;
+    } else {
+        a = best_top + d;
+        b = best_bot;
+        n = -d;
+    }
+    tty_out_csi2(s, a + 1, b, 'r');
+    tty_out_csi2(s, a + 1, 1, 'H');
+    tty_out_csi(s, n, d > 0 ? 'M' : 'L');
+    /* resetting the scroll region homes the cursor */
+    tty_out_puts(s, "\033[r");
+    ts->out_x = ts->out_y = 0;
+
+    memmove(ts->screen + shadow + best_top * w,
+            ts->screen + shadow + (best_top + d) * w,
+            (best_bot - best_top) * w * sizeof(TTYChar));
+    /* exposed rows have blank contents: force their update */
+    if (d > 0)
+        y = best_bot;
+    else
+        y = a;
+    memset(ts->screen + shadow + y * w, 0xFF, n * w * sizeof(TTYChar));
+    memset(ts->line_updated + a, 1, b - a);
+}
+
+/* length of the decimal representation of n */
+static int tty_num_len(unsigned int n)
+{
+    int len = 1;
+
+    while (n >= 10) {
+        n /= 10;
+        len++;
+    }
+    return len;
+}
+
+/* Move the cursor to column x of row y with the shortest sequence.
+ * ts->out_x is s->width if the last column was just output (pending
+ * wrap) and -1 if the cursor position is unknown.
+ */
+static void tty_goto(QEditScreen *s, int x, int y)
+{
+    TTYState *ts = s->priv_data;
+    int dx = x - ts->out_x;
+    int cost, best, how;
+
+    if (ts->out_y == y && dx == 0)
+        return;
+
+    /* CSI y ; x H */
+    best = 4 + tty_num_len(y + 1) + tty_num_len(x + 1);
+    how = 'H';
+    if (ts->out_y == y && ts->out_x >= 0 && ts->out_x < s->width) {
+        /* CSI n C or CSI n D */
+        cost = 3 + tty_num_len(abs(dx));
+        if (cost < best) {
+            best = cost;
+            how = dx > 0 ? 'C' : 'D';
+        }
+    }
+    if (ts->out_y == y || (ts->out_y >= 0 && ts->out_y + 1 == y)) {
+        /* CR, optional LF, optional CSI x C */
+        cost = 1 + (ts->out_y != y) + (x ? 3 + tty_num_len(x) : 0);
+        if (cost < best) {
+            best = cost;
+            how = '\r';
+        }
+    }
+    switch (how) {
+    case 'H':
+        tty_out_csi2(s, y + 1, x + 1, 'H');
+        break;
+    case 'C':
+        tty_out_csi(s, dx, 'C');
+        break;
+    case 'D':
+        tty_out_csi(s, -dx, 'D');
+        break;
+    default:
+        tty_out_putc(s, '\r');
+        if (ts->out_y != y)
+            tty_out_putc(s, '\n');
+        if (x)
+            tty_out_csi(s, x, 'C');
+        break;
+    }
+    ts->out_x = x;
+    ts->out_y = y;
+}
+
+/* Detect a few cells inserted or deleted in the middle of a row, such
+ * as characters typed in a line of text, and shift the rest of the
+ * row with ICH or DCH instead of rewriting it.  Update the shadow row
+ * accordingly and return 1 if the row was shifted.
+ */
+static int tty_shift_row(QEditScreen *s, int y, TTYChar *ptr1, TTYChar *ptr2)
+{
+    TTYState *ts = s->priv_data;
+    int shadow = ts->screen_size;
+    TTYChar *ptr = ts->screen + y * s->width;
+    TTYChar *end = ptr + s->width;
+    int k, n;
+
+    /* do not split double width glyphs, do not scroll the screen
+     * by shifting a character into the bottom right cell */
+    if (y == s->height - 1
+    ||  (unsigned int)TTY_CHAR_GET_CH(*ptr1) == TTY_CHAR_NONE
+    ||  (unsigned int)TTY_CHAR_GET_CH(ptr1[shadow]) == TTY_CHAR_NONE)
+        return 0;
+
+    for (k = 1; k <= 8 && 3 + tty_num_len(k) + k < ptr2 - ptr1; k++) {
+        n = (end - ptr1 - k) * sizeof(TTYChar);
+        if (!memcmp(ptr1 + k, ptr1 + shadow, n)) {
+            /* k cells inserted at ptr1 */
+            tty_goto(s, ptr1 - ptr, y);
+            tty_out_csi(s, k, '@');
+            memmove(ptr1 + shadow + k, ptr1 + shadow, n);
+            /* force the update of the inserted blanks */
+            memset(ptr1 + shadow, 0xFF, k * sizeof(TTYChar));
+            return 1;
+        }
+        if (!memcmp(ptr1, ptr1 + shadow + k, n)) {
+            /* k cells deleted at ptr1 */
+            tty_goto(s, ptr1 - ptr, y);
+            tty_out_csi(s, k, 'P');
+            memmove(ptr1 + shadow, ptr1 + shadow + k, n);
+            memset(end - k + shadow, 0xFF, k * sizeof(TTYChar));
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Output the attribute changes for cell cc as a single SGR sequence */
+static void tty_out_sgr(QEditScreen *s, TTYChar cc)
+{
+    TTYState *ts = s->priv_data;
+    int bgcolor = TTY_CHAR_GET_BG(cc);
+    int fgcolor = TTY_CHAR_GET_FG(cc);
+    int attr = TTY_CHAR_GET_COL(cc);
+    int lastbg = ts->out_bg;
+    int lastfg = ts->out_fg;
+    int lastattr = ts->out_attr;
+    char buf[64];
+    buf_t out[1];
+
+    if (ts->low_bandwidth && bgcolor == 7)
+        fgcolor = 0;
+
+    buf_init(out, buf, sizeof(buf));
+
+    if (lastbg != bgcolor) {
+        ts->out_bg = bgcolor;
+#if TTY_STYLE_BITS == 32
+        if (ts->term_bg_colors_count > 256 && bgcolor >= 256) {
+            /* XXX: should special case dynamic palette */
+            QEColor rgb = qe_unmap_color(bgcolor, ts->tty_bg_colors_count);
+            buf_printf(out, ";48;2;%d;%d;%d", (rgb >> 16) & 255,
+                       (rgb >> 8) & 255, (rgb >> 0) & 255);
+        } else
+#endif
+        if (ts->term_bg_colors_count > 16 && bgcolor >= 16) {
+            buf_printf(out, ";48;5;%d", bgcolor);
+        } else
+        if (ts->term_flags & USE_BLINK_AS_BRIGHT_BG) {
+            if (bgcolor > 7) {
+                if (lastbg <= 7)
+                    buf_puts(out, ";5");
+            } else {
+                if (lastbg > 7)
+                    buf_puts(out, ";25");
+            }
+            buf_printf(out, ";%d", 40 + (bgcolor & 7));
+        } else {
+            buf_printf(out, ";%d", bgcolor > 7 ? 100 + bgcolor - 8 :
+                       40 + bgcolor);
+        }
+    }
+    /* do not special case SPC on fg color change
+     * because of combining marks */
+    if (lastfg != fgcolor) {
+        ts->out_fg = fgcolor;
+#if TTY_STYLE_BITS == 32
+        if (ts->term_fg_colors_count > 256 && fgcolor >= 256) {
+            QEColor rgb = qe_unmap_color(fgcolor, ts->tty_fg_colors_count);
+            buf_printf(out, ";38;2;%d;%d;%d", (rgb >> 16) & 255,
+                       (rgb >> 8) & 255, (rgb >> 0) & 255);
+        } else
+#endif
+        if (ts->term_fg_colors_count > 16 && fgcolor >= 16) {
+            buf_printf(out, ";38;5;%d", fgcolor);
+        } else
+        if (ts->term_flags & USE_BOLD_AS_BRIGHT_FG) {
+            if (fgcolor > 7) {
+                if (lastfg <= 7)
+                    buf_puts(out, ";1");
+            } else {
+                if (lastfg > 7)
+                    buf_puts(out, ";22");
+            }
+            buf_printf(out, ";%d", 30 + (fgcolor & 7));
+        } else {
+            buf_printf(out, ";%d", fgcolor > 7 ? 90 + fgcolor - 8 :
+                       30 + fgcolor);
+        }
+    }
+    if (lastattr != attr) {
+        ts->out_attr = attr;
+        if ((attr ^ lastattr) & TTY_BOLD)
+            buf_puts(out, (attr & TTY_BOLD) ? ";1" : ";22");
+        if ((attr ^ lastattr) & TTY_UNDERLINE)
+            buf_puts(out, (attr & TTY_UNDERLINE) ? ";4" : ";24");
+        if ((attr ^ lastattr) & TTY_BLINK)
+            buf_puts(out, (attr & TTY_BLINK) ? ";5" : ";25");
+        if ((attr ^ lastattr) & TTY_ITALIC)
+            buf_puts(out, (attr & TTY_ITALIC) ? ";3" : ";23");
+    }
+    if (out->len) {
+        tty_out_write(s, "\033[", 2);
+        tty_out_write(s, buf + 1, out->len - 1);
+        tty_out_putc(s, 'm');
+    }
+}
+
+/* Update the output statistics after a frame and switch to cheaper
+ * rendering when the measured throughput is low.
+ */
+static void tty_update_bandwidth(QEditScreen *s)
+{
+    TTYState *ts = s->priv_data;
+    QEmacsState *qs = &qe_state;
+    int threshold = qs->tty_low_bandwidth;
+    int rate, low;
+
+    ts->out_frames++;
+    ts->out_bytes += ts->frame_bytes;
+    ts->out_usec += ts->frame_usec;
+    ts->max_frame_bytes = max(ts->max_frame_bytes, ts->frame_bytes);
+    ts->max_frame_usec = max(ts->max_frame_usec, ts->frame_usec);
+    ts->out_blocked = (ts->frame_usec > 50000);
+
+    /* writes that do not block only fill the kernel buffers: their
+     * duration gives a lower bound of the throughput */
+    if (ts->frame_bytes >= 256) {
+        rate = (int)((int64_t)ts->frame_bytes * 1000000 /
+                     max(ts->frame_usec, 10000));
+        ts->out_rate = ts->out_rate ? (3 * ts->out_rate + rate) / 4 : rate;
+    }
+    ts->frame_bytes = ts->frame_usec = 0;
+
+    low = ts->low_bandwidth;
+    if (threshold <= 0) {
+        low = 0;
+    } else
+    if (ts->out_rate) {
+        if (ts->out_rate < threshold)
+            low = 1;
+        else
+        if (ts->out_rate > 2 * threshold)
+            low = 0;
+    }
+    if (low != ts->low_bandwidth) {
+        ts->low_bandwidth = low;
+        /* redraw the whole screen with the new rendering */
+        qs->complete_refresh = 1;
+        url_redisplay();
+    }
+}
+
 static void tty_dpy_flush(QEditScreen *s)
 {
     TTYState *ts = s->priv_data;
-    TTYChar *ptr, *ptr1, *ptr2, *ptr3, *ptr4, cc, blankcc;
-    int y, shadow, ch, bgcolor, fgcolor, shifted, attr;
+    TTYChar *ptr, *ptr1, *ptr2, *ptr3, *ptr4, *ptr5, cc, blankcc;
+    int y, shadow, ch, shifted, n, frame_start, body_start;
+
+    if (ts->out_blocked && tty_dpy_is_user_input_pending(s)) {
+        /* the terminal cannot keep up: skip this frame, the pending
+         * input will cause another one */
+        ts->out_dropped++;
+        return;
+    }
 
-    /* Hide cursor, goto home, reset attributes */
-    TTY_FPUTS("\033[?25l\033[H\033[0m", s->STDOUT);
+    /* Begin synchronized update, hide cursor, reset attributes */
+    frame_start = ts->outbuf_len;
+    if (ts->term_flags & USE_SYNC_UPDATE)
+        tty_out_puts(s, "\033[?2026h");
+    tty_out_puts(s, "\033[?25l\033[0m");
 
     if (ts->term_code != TERM_CYGWIN) {
-        TTY_FPUTS("\033(B\033)0", s->STDOUT);
+        tty_out_puts(s, "\033(B\033)0");
     }
+    body_start = ts->outbuf_len;
 
-    bgcolor = -1;
-    fgcolor = -1;
-    attr = 0;
+    ts->out_x = ts->out_y = -1;
+    ts->out_bg = ts->out_fg = -1;
+    ts->out_attr = 0;
     shifted = 0;
 
-    /* CG: Should optimize output by computing it in a temporary buffer
-     * and flushing it in one call to fwrite()
-     */
-
     shadow = ts->screen_size;
     /* We cannot print anything on the bottom right screen cell,
      * pretend it's OK: */
+    comb_cache_release(ts, ts->screen + shadow - 1, 1);
+    comb_cache_ref(ts, ts->screen[2 * shadow - 1]);
     ts->screen[shadow - 1] = ts->screen[2 * shadow - 1];
 
+    if (ts->term_flags & USE_SCROLL_REGION)
+        tty_scroll_rows(s);
+
     for (y = 0; y < s->height; y++) {
         if (ts->line_updated[y]) {
             ts->line_updated[y] = 0;
+        again:
             ptr = ptr1 = ts->screen + y * s->width;
             ptr3 = ptr2 = ptr1 + s->width;
 
@@ -1154,6 +2039,11 @@ static void tty_dpy_flush(QEditScreen *s)
                 --ptr2;
             }
 
+            if ((ts->term_flags & USE_INSERT_CHARS)
+            &&  tty_shift_row(s, y, ptr1, ptr2)) {
+                goto again;
+            }
+
             ptr4 = ptr2;
 
             /* Try to optimize with erase to end of line: if the last
@@ -1195,140 +2085,92 @@ static void tty_dpy_flush(QEditScreen *s)
              * double-width glyphs on the row in front of this
              * difference (actually it should)
              */
-            TTY_FPRINTF(s->STDOUT, "\033[%d;%dH",
-                        y + 1, (int)(ptr1 - ptr + 1));
+            tty_goto(s, ptr1 - ptr, y);
 
             while (ptr1 < ptr4) {
                 cc = *ptr1;
+                ch = TTY_CHAR_GET_CH(cc);
+                if (cc == ptr1[shadow] && (unsigned int)ch != TTY_CHAR_NONE) {
+                    /* skip a run of unchanged cells if moving the
+                     * cursor is cheaper than overwriting them
+                     */
+                    ptr5 = ptr1 + 1;
+                    while (ptr5 < ptr4 && *ptr5 == ptr5[shadow])
+                        ptr5++;
+                    while (ptr5 > ptr1 && ptr5 < ptr4
+                       &&  TTY_CHAR_GET_CH(*ptr5) == TTY_CHAR_NONE)
+                        ptr5--;
+                    n = ptr5 - ptr1;
+                    if (n > 3 + tty_num_len(n)) {
+                        ptr1 = ptr5;
+                        tty_goto(s, ptr1 - ptr, y);
+                        continue;
+                    }
+                }
                 ptr1[shadow] = cc;
                 ptr1++;
-                ch = TTY_CHAR_GET_CH(cc);
                 if ((unsigned int)ch != TTY_CHAR_NONE) {
-                    /* output attributes */
-                    if (bgcolor != (int)TTY_CHAR_GET_BG(cc)) {
-                        int lastbg = bgcolor;
-                        bgcolor = TTY_CHAR_GET_BG(cc);
-#if TTY_STYLE_BITS == 32
-                        if (ts->term_bg_colors_count > 256 && bgcolor >= 256) {
-                            /* XXX: should special case dynamic palette */
-                            QEColor rgb = qe_unmap_color(bgcolor, ts->tty_bg_colors_count);
-                            TTY_FPRINTF(s->STDOUT, "\033[48;2;%d;%d;%dm",
-                                        (rgb >> 16) & 255, (rgb >> 8) & 255, (rgb >> 0) & 255);
-                        } else
-#endif
-                        if (ts->term_bg_colors_count > 16 && bgcolor >= 16) {
-                            TTY_FPRINTF(s->STDOUT, "\033[48;5;%dm", bgcolor);
-                        } else
-                        if (ts->term_flags & USE_BLINK_AS_BRIGHT_BG) {
-                            if (bgcolor > 7) {
-                                if (lastbg <= 7) {
-                                    TTY_FPUTS("\033[5m", s->STDOUT);
-                                }
-                            } else {
-                                if (lastbg > 7) {
-                                    TTY_FPUTS("\033[25m", s->STDOUT);
-                                }
-                            }
-                            TTY_FPRINTF(s->STDOUT, "\033[%dm", 40 + (bgcolor & 7));
-                        } else {
-                            TTY_FPRINTF(s->STDOUT, "\033[%dm",
-                                        bgcolor > 7 ? 100 + bgcolor - 8 :
-                                        40 + bgcolor);
-                        }
-                    }
-                    /* do not special case SPC on fg color change
-                    * because of combining marks */
-                    if (fgcolor != (int)TTY_CHAR_GET_FG(cc)) {
-                        int lastfg = fgcolor;
-                        fgcolor = TTY_CHAR_GET_FG(cc);
-#if TTY_STYLE_BITS == 32
-                        if (ts->term_fg_colors_count > 256 && fgcolor >= 256) {
-                            QEColor rgb = qe_unmap_color(fgcolor, ts->tty_fg_colors_count);
-                            TTY_FPRINTF(s->STDOUT, "\033[38;2;%d;%d;%dm",
-                                        (rgb >> 16) & 255, (rgb >> 8) & 255, (rgb >> 0) & 255);
-                        } else
-#endif
-                        if (ts->term_fg_colors_count > 16 && fgcolor >= 16) {
-                            TTY_FPRINTF(s->STDOUT, "\033[38;5;%dm", fgcolor);
-                        } else
-                        if (ts->term_flags & USE_BOLD_AS_BRIGHT_FG) {
-                            if (fgcolor > 7) {
-                                if (lastfg <= 7) {
-                                    TTY_FPUTS("\033[1m", s->STDOUT);
-                                }
-                            } else {
-                                if (lastfg > 7) {
-                                    TTY_FPUTS("\033[22m", s->STDOUT);
-                                }
-                            }
-                            TTY_FPRINTF(s->STDOUT, "\033[%dm", 30 + (fgcolor & 7));
-                        } else {
-                            TTY_FPRINTF(s->STDOUT, "\033[%dm",
-                                        fgcolor > 8 ? 90 + fgcolor - 8 :
-                                        30 + fgcolor);
-                        }
-                    }
-                    if (attr != (int)TTY_CHAR_GET_COL(cc)) {
-                        int lastattr = attr;
-                        attr = TTY_CHAR_GET_COL(cc);
+                    tty_out_sgr(s, cc);
 
-                        if ((attr ^ lastattr) & TTY_BOLD) {
-                            if (attr & TTY_BOLD) {
-                                TTY_FPUTS("\033[1m", s->STDOUT);
-                            } else {
-                                TTY_FPUTS("\033[22m", s->STDOUT);
-                            }
-                        }
-                        if ((attr ^ lastattr) & TTY_UNDERLINE) {
-                            if (attr & TTY_UNDERLINE) {
-                                TTY_FPUTS("\033[4m", s->STDOUT);
-                            } else {
-                                TTY_FPUTS("\033[24m", s->STDOUT);
-                            }
-                        }
-                        if ((attr ^ lastattr) & TTY_BLINK) {
-                            if (attr & TTY_BLINK) {
-                                TTY_FPUTS("\033[5m", s->STDOUT);
-                            } else {
-                                TTY_FPUTS("\033[25m", s->STDOUT);
-                            }
-                        }
-                        if ((attr ^ lastattr) & TTY_ITALIC) {
-                            if (attr & TTY_ITALIC) {
-                                TTY_FPUTS("\033[3m", s->STDOUT);
-                            } else {
-                                TTY_FPUTS("\033[23m", s->STDOUT);
-                            }
+                    /* measure the run of identical cells */
+                    for (ptr5 = ptr1; ptr5 < ptr4 && *ptr5 == cc; ptr5++)
+                        continue;
+                    n = ptr5 - ptr1 + 1;
+
+                    /* erase a run of blanks in place: ECH does not
+                     * move the cursor and uses the current background
+                     * color, like EL.
+                     */
+                    if (ch == ' ' && n > 2 * (3 + tty_num_len(n))
+                    &&  (ts->term_flags & USE_ERASE_CHARS)
+                    &&  !(ts->term_flags & USE_REPEAT_CHAR)
+                    &&  !(TTY_CHAR_GET_COL(cc) & TTY_UNDERLINE)
+                    &&  TTY_CHAR_GET_BG(cc) < 8) {
+                        tty_out_csi(s, n, 'X');
+                        while (ptr1 < ptr5) {
+                            ptr1[shadow] = cc;
+                            ptr1++;
                         }
+                        tty_goto(s, ptr1 - ptr, y);
+                        continue;
                     }
+
                     if (shifted) {
                         /* Kludge for linedrawing chars */
                         if (ch < 128 || ch >= 128 + 32) {
-                            TTY_FPUTS("\033(B", s->STDOUT);
+                            tty_out_puts(s, "\033(B");
                             shifted = 0;
                         }
                     }
 
                     /* do not display escape codes or invalid codes */
                     if (ch < 32 || ch == 127) {
-                        TTY_PUTC('.', s->STDOUT);
+                        tty_out_putc(s, '.');
                     } else
                     if (ch < 127) {
-                        TTY_PUTC(ch, s->STDOUT);
+                        tty_out_putc(s, ch);
+                        /* REP the run of identical characters */
+                        if ((ts->term_flags & USE_REPEAT_CHAR)
+                        &&  n - 1 > 3 + tty_num_len(n - 1)) {
+                            tty_out_csi(s, n - 1, 'b');
+                            while (ptr1 < ptr5) {
+                                ptr1[shadow] = cc;
+                                ptr1++;
+                            }
+                        }
                     } else
                     if (ch < 128 + 32) {
                         /* Kludges for linedrawing chars */
                         if (ts->term_code == TERM_CYGWIN) {
                             static const char unitab_xterm_poorman[32] =
                                 "*#****o~**+++++-----++++|****L. ";
-                            TTY_PUTC(unitab_xterm_poorman[ch - 128],
-                                     s->STDOUT);
+                            tty_out_putc(s, unitab_xterm_poorman[ch - 128]);
                         } else {
                             if (!shifted) {
-                                TTY_FPUTS("\033(0", s->STDOUT);
+                                tty_out_puts(s, "\033(0");
                                 shifted = 1;
                             }
-                            TTY_PUTC(ch - 32, s->STDOUT);
+                            tty_out_putc(s, ch - 32);
                         }
                     } else
 #if COMB_CACHE_SIZE > 1
@@ -1341,7 +2183,7 @@ static void tty_dpy_flush(QEditScreen *s)
                             while (ncc-- > 1) {
                                 q = s->charset->encode_func(s->charset, buf, *ip++);
                                 if (q) {
-                                    TTY_FWRITE(buf, 1, q - buf, s->STDOUT);
+                                    tty_out_write(s, buf, q - buf);
                                 }
                             }
                         }
@@ -1371,22 +2213,33 @@ static void tty_dpy_flush(QEditScreen *s)
 
                         nc = q - buf;
                         if (nc == 1) {
-                            TTY_PUTC(*buf, s->STDOUT);
+                            tty_out_putc(s, *buf);
                         } else {
-                            TTY_FWRITE(buf, 1, nc, s->STDOUT);
+                            tty_out_write(s, buf, nc);
                         }
                     }
                 }
+                /* the cursor follows the cells, double width glyphs
+                 * span their TTY_CHAR_NONE continuation cell */
+                ts->out_x = ptr1 - ptr;
+            }
+            if (ptr1 < ptr + s->width
+            &&  (unsigned int)TTY_CHAR_GET_CH(*ptr1) == TTY_CHAR_NONE) {
+                /* stopped inside a double width glyph */
+                ts->out_x = -1;
             }
             if (shifted) {
-                TTY_FPUTS("\033(B", s->STDOUT);
+                tty_out_puts(s, "\033(B");
                 shifted = 0;
             }
             if (ptr1 < ptr2) {
                 /* More differences to synch in shadow, erase eol */
                 cc = *ptr1;
-                /* the current attribute is already set correctly */
-                TTY_FPUTS("\033[K", s->STDOUT);
+                /* unchanged cells may have been skipped: make sure
+                 * the background color is set */
+                tty_out_sgr(s, cc);
+                tty_goto(s, ptr1 - ptr, y);
+                tty_out_puts(s, "\033[K");
                 while (ptr1 < ptr2) {
                     ptr1[shadow] = cc;
                     ptr1++;
@@ -1394,24 +2247,46 @@ static void tty_dpy_flush(QEditScreen *s)
             }
 //            if (ts->term_flags & USE_BLINK_AS_BRIGHT_BG)
             {
-                if (bgcolor > 7) {
-                    TTY_FPUTS("\033[0m", s->STDOUT);
-                    fgcolor = bgcolor = -1;
-                    attr = 0;
+                if (ts->out_bg > 7) {
+                    tty_out_puts(s, "\033[0m");
+                    ts->out_fg = ts->out_bg = -1;
+                    ts->out_attr = 0;
                 }
             }
         }
     }
 
-    TTY_FPUTS("\033[0m", s->STDOUT);
-    if (ts->cursor_y + 1 >= 0 && ts->cursor_x + 1 >= 0) {
-        TTY_FPRINTF(s->STDOUT, "\033[?25h\033[%d;%dH",
-                    ts->cursor_y + 1, ts->cursor_x + 1);
+    if (ts->outbuf_len == body_start) {
+        /* nothing changed on screen: only update the cursor */
+        ts->outbuf_len = frame_start;
+        if (ts->cursor_y == ts->out_cursor_y
+        &&  ts->cursor_x == ts->out_cursor_x) {
+            return;
+        }
+        if (ts->cursor_y + 1 >= 0 && ts->cursor_x + 1 >= 0) {
+            tty_out_csi2(s, ts->cursor_y + 1, ts->cursor_x + 1, 'H');
+            if (ts->out_cursor_y + 1 < 0 || ts->out_cursor_x + 1 < 0)
+                tty_out_puts(s, "\033[?25h");
+        } else {
+            tty_out_puts(s, "\033[?25l");
+        }
+    } else {
+        if (ts->out_fg != -1 || ts->out_bg != -1 || ts->out_attr != 0)
+            tty_out_puts(s, "\033[0m");
+        if (ts->term_flags & USE_SYNC_UPDATE)
+            tty_out_puts(s, "\033[?2026l");
+        if (ts->cursor_y + 1 >= 0 && ts->cursor_x + 1 >= 0) {
+            tty_out_csi2(s, ts->cursor_y + 1, ts->cursor_x + 1, 'H');
+            tty_out_puts(s, "\033[?25h");
+        }
     }
-    fflush(s->STDOUT);
+    ts->out_cursor_x = ts->cursor_x;
+    ts->out_cursor_y = ts->cursor_y;
+    tty_out_flush(s);
+    tty_update_bandwidth(s);
 
-    /* Update combination cache from screen. Should do this before redisplay */
-    comb_cache_clean(ts, ts->screen, ts->screen_size);
+    /* The shadow buffer matches the screen: free unused combinations */
+    comb_cache_collect(ts);
 }
 
 static int tty_dpy_bmp_alloc(QEditScreen *s, QEBitmap *bp) {
@@ -1471,6 +2346,7 @@ static void tty_dpy_bmp_draw(QEditScreen *s, QEBitmap *bp,
             unsigned char *p1 = data + (src_y + y * 2) * linesize + src_x;
             unsigned char *p2 = p1 + linesize;
             ts->line_updated[dst_y + y] = 1;
+            comb_cache_release(ts, ptr, dst_w);
             for (x = 0; x < dst_w; x++) {
                 int bg = p1[x];
                 int fg = p2[x];
@@ -1489,6 +2365,7 @@ static void tty_dpy_bmp_draw(QEditScreen *s, QEBitmap *bp,
             QEColor *p1 = (QEColor *)(void*)(data + (src_y + y * 2) * linesize) + src_x;
             QEColor *p2 = (QEColor *)(void*)((unsigned char*)p1 + linesize);
             ts->line_updated[dst_y + y] = 1;
+            comb_cache_release(ts, ptr, dst_w);
             for (x = 0; x < dst_w; x++) {
                 QEColor bg3 = p1[x];
                 QEColor fg3 = p2[x];
@@ -1531,6 +2408,7 @@ static int tty_dpy_draw_picture(QEditScreen *s,
             unsigned char *p1 = ip->data[0] + (src_y + y * 2) * ip->linesize[0] + src_x;
             unsigned char *p2 = p1 + ip->linesize[0];
             ts->line_updated[dst_y + y] = 1;
+            comb_cache_release(ts, ptr, dst_w);
             for (x = 0; x < dst_w; x++) {
                 int bg = p1[x];
                 int fg = p2[x];
@@ -1565,6 +2443,7 @@ static int tty_dpy_draw_picture(QEditScreen *s,
             uint32_t *p1 = (uint32_t*)(void*)(ip->data[0] + (src_y + y * 2) * ip->linesize[0]) + src_x;
             uint32_t *p2 = p1 + (ip->linesize[0] >> 2);
             ts->line_updated[dst_y + y] = 1;
+            comb_cache_release(ts, ptr, dst_w);
             for (x = 0; x < dst_w; x++) {
                 int bg = p1[x];
                 int fg = p2[x];
@@ -1583,9 +2462,29 @@ static int tty_dpy_draw_picture(QEditScreen *s,
 }
 #endif
 
+static void tty_describe_output(QEditScreen *s, EditBuffer *b)
+{
+    TTYState *ts = s->priv_data;
+    unsigned int n = max(ts->out_frames, 1U);
+    int w = 16;
+
+    eb_printf(b, "\nOutput statistics:\n\n");
+    eb_printf(b, "%*s: %u, %u dropped\n", w, "frames",
+              ts->out_frames, ts->out_dropped);
+    eb_printf(b, "%*s: %llu total, %llu avg, %d max\n", w, "bytes",
+              (unsigned long long)ts->out_bytes,
+              (unsigned long long)(ts->out_bytes / n), ts->max_frame_bytes);
+    eb_printf(b, "%*s: %lld total, %lld avg, %d max\n", w, "write usec",
+              (long long)ts->out_usec, (long long)(ts->out_usec / n),
+              ts->max_frame_usec);
+    eb_printf(b, "%*s: %d bytes/s%s\n", w, "throughput", ts->out_rate,
+              ts->low_bandwidth ? " (low bandwidth rendering)" : "");
+}
+
 static void tty_dpy_describe(QEditScreen *s, EditBuffer *b)
 {
     comb_cache_describe(s, b);
+    tty_describe_output(s, b);
 }
 
 static QEDisplay tty_dpy = {
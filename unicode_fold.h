@@ -0,0 +1,1298 @@
+/* This file was generated automatically by unifold from UnicodeData.txt */
+
+#define UNICODE_FOLD_LIMIT  0x20000
+#define UNICODE_FOLD_SHIFT  7
+
+/* simple case folding */
+static unsigned char const unicode_fold_case_index[1024] = {
+      0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,  11,   5,   5,   5,   5,   5,  12,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,  13,   5,   5,  14,  15,  16,  17,
+      5,   5,  18,  19,   5,   5,   5,   5,   5,  20,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,  21,  22,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,  23,  24,  25,  26,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,  27,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,  28,  29,  30,  31,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,  32,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,  33,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,  34,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,  35,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+};
+
+static int const unicode_fold_case[36][128] = {
+    {   /* 00000 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 32, 32, 32, 32, 32, 32, 32,
+        32, 32, 32, 32, 32, 32, 32, 32,
+        32, 32, 32, 32, 32, 32, 32, 32,
+        32, 32, 32, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 00080 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 775, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        32, 32, 32, 32, 32, 32, 32, 32,
+        32, 32, 32, 32, 32, 32, 32, 32,
+        32, 32, 32, 32, 32, 32, 32, 0,
+        32, 32, 32, 32, 32, 32, 32, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 00100 */
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        -199, -200, 1, 0, 1, 0, 1, 0,
+        0, 1, 0, 1, 0, 1, 0, 1,
+        0, 1, 0, 1, 0, 1, 0, 1,
+        0, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        -121, 1, 0, 1, 0, 1, 0, -268,
+    },
+    {   /* 00180 */
+        0, 210, 1, 0, 1, 0, 206, 1,
+        0, 205, 205, 1, 0, 0, 79, 202,
+        203, 1, 0, 205, 207, 0, 211, 209,
+        1, 0, 0, 0, 211, 213, 0, 214,
+        1, 0, 1, 0, 1, 0, 218, 1,
+        0, 218, 0, 0, 1, 0, 218, 1,
+        0, 217, 217, 1, 0, 1, 0, 219,
+        1, 0, 0, 0, 1, 0, 0, 0,
+        0, 0, 0, 0, 2, 1, 0, 2,
+        1, 0, 2, 1, 0, 1, 0, 1,
+        0, 1, 0, 1, 0, 1, 0, 1,
+        0, 1, 0, 1, 0, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        0, 2, 1, 0, 1, 0, -97, -56,
+        1, 0, 1, 0, 1, 0, 1, 0,
+    },
+    {   /* 00200 */
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        -130, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 0, 0, 0, 0,
+        0, 0, 10795, 1, 0, -163, 10792, 0,
+        0, 1, 0, -195, 69, 71, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 00280 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 00300 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 116, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        1, 0, 1, 0, 0, 0, 1, 0,
+        0, 0, 0, 0, 0, 0, 0, 116,
+    },
+    {   /* 00380 */
+        0, 0, 0, 0, 0, 0, 38, 0,
+        37, 37, 37, 0, 64, 0, 63, 63,
+        0, 32, 32, 32, 32, 32, 32, 32,
+        32, 32, 32, 32, 32, 32, 32, 32,
+        32, 32, 0, 32, 32, 32, 32, 32,
+        32, 32, 32, 32, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 1, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 8,
+        -30, -25, 0, 0, 0, -15, -22, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        -54, -48, 0, 0, -60, -64, 0, 1,
+        0, -7, 1, 0, 0, -130, -130, -130,
+    },
+    {   /* 00400 */
+        80, 80, 80, 80, 80, 80, 80, 80,
+        80, 80, 80, 80, 80, 80, 80, 80,
+        32, 32, 32, 32, 32, 32, 32, 32,
+        32, 32, 32, 32, 32, 32, 32, 32,
+        32, 32, 32, 32, 32, 32, 32, 32,
+        32, 32, 32, 32, 32, 32, 32, 32,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+    },
+    {   /* 00480 */
+        1, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        15, 1, 0, 1, 0, 1, 0, 1,
+        0, 1, 0, 1, 0, 1, 0, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+    },
+    {   /* 00500 */
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        0, 48, 48, 48, 48, 48, 48, 48,
+        48, 48, 48, 48, 48, 48, 48, 48,
+        48, 48, 48, 48, 48, 48, 48, 48,
+        48, 48, 48, 48, 48, 48, 48, 48,
+        48, 48, 48, 48, 48, 48, 48, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 01080 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        7264, 7264, 7264, 7264, 7264, 7264, 7264, 7264,
+        7264, 7264, 7264, 7264, 7264, 7264, 7264, 7264,
+        7264, 7264, 7264, 7264, 7264, 7264, 7264, 7264,
+        7264, 7264, 7264, 7264, 7264, 7264, 7264, 7264,
+        7264, 7264, 7264, 7264, 7264, 7264, 0, 7264,
+        0, 0, 0, 0, 0, 7264, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 01380 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        38864, 38864, 38864, 38864, 38864, 38864, 38864, 38864,
+        38864, 38864, 38864, 38864, 38864, 38864, 38864, 38864,
+        38864, 38864, 38864, 38864, 38864, 38864, 38864, 38864,
+        38864, 38864, 38864, 38864, 38864, 38864, 38864, 38864,
+        38864, 38864, 38864, 38864, 38864, 38864, 38864, 38864,
+        38864, 38864, 38864, 38864, 38864, 38864, 38864, 38864,
+        38864, 38864, 38864, 38864, 38864, 38864, 38864, 38864,
+        38864, 38864, 38864, 38864, 38864, 38864, 38864, 38864,
+        38864, 38864, 38864, 38864, 38864, 38864, 38864, 38864,
+        38864, 38864, 38864, 38864, 38864, 38864, 38864, 38864,
+        8, 8, 8, 8, 8, 8, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 01C80 */
+        -6222, -6221, -6212, -6210, -6210, -6211, -6204, -6180,
+        35267, 0, 0, 0, 0, 0, 0, 0,
+        -3008, -3008, -3008, -3008, -3008, -3008, -3008, -3008,
+        -3008, -3008, -3008, -3008, -3008, -3008, -3008, -3008,
+        -3008, -3008, -3008, -3008, -3008, -3008, -3008, -3008,
+        -3008, -3008, -3008, -3008, -3008, -3008, -3008, -3008,
+        -3008, -3008, -3008, -3008, -3008, -3008, -3008, -3008,
+        -3008, -3008, -3008, 0, 0, -3008, -3008, -3008,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 01E00 */
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+    },
+    {   /* 01E80 */
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 0, 0,
+        0, 0, 0, -58, 0, 0, -7615, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+    },
+    {   /* 01F00 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        -8, -8, -8, -8, -8, -8, -8, -8,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        -8, -8, -8, -8, -8, -8, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        -8, -8, -8, -8, -8, -8, -8, -8,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        -8, -8, -8, -8, -8, -8, -8, -8,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        -8, -8, -8, -8, -8, -8, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, -8, 0, -8, 0, -8, 0, -8,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        -8, -8, -8, -8, -8, -8, -8, -8,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 01F80 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        -8, -8, -8, -8, -8, -8, -8, -8,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        -8, -8, -8, -8, -8, -8, -8, -8,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        -8, -8, -8, -8, -8, -8, -8, -8,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        -8, -8, -74, -74, -9, 0, -7173, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        -86, -86, -86, -86, -9, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        -8, -8, -100, -100, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        -8, -8, -112, -112, -7, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        -128, -128, -126, -126, -9, 0, 0, 0,
+    },
+    {   /* 02100 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, -7517, 0,
+        0, 0, -8383, -8262, 0, 0, 0, 0,
+        0, 0, 28, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        16, 16, 16, 16, 16, 16, 16, 16,
+        16, 16, 16, 16, 16, 16, 16, 16,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 02180 */
+        0, 0, 0, 1, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 02480 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 26, 26,
+        26, 26, 26, 26, 26, 26, 26, 26,
+        26, 26, 26, 26, 26, 26, 26, 26,
+        26, 26, 26, 26, 26, 26, 26, 26,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 02C00 */
+        48, 48, 48, 48, 48, 48, 48, 48,
+        48, 48, 48, 48, 48, 48, 48, 48,
+        48, 48, 48, 48, 48, 48, 48, 48,
+        48, 48, 48, 48, 48, 48, 48, 48,
+        48, 48, 48, 48, 48, 48, 48, 48,
+        48, 48, 48, 48, 48, 48, 48, 48,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        1, 0, -10743, -3814, -10727, 0, 0, 1,
+        0, 1, 0, 1, 0, -10780, -10749, -10783,
+        -10782, 0, 1, 0, 0, 1, 0, 0,
+        0, 0, 0, 0, 0, 0, -10815, -10815,
+    },
+    {   /* 02C80 */
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 0, 0, 0, 0,
+        0, 0, 0, 1, 0, 1, 0, 0,
+        0, 0, 1, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 0A600 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 0A680 */
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 0A700 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        0, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 1, 0, 1, 0, -35332, 1, 0,
+    },
+    {   /* 0A780 */
+        1, 0, 1, 0, 1, 0, 1, 0,
+        0, 0, 0, 1, 0, -42280, 0, 0,
+        1, 0, 1, 0, 0, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, -42308, -42319, -42315, -42305, -42308, 0,
+        -42258, -42282, -42261, 928, 1, 0, 1, 0,
+        1, 0, 1, 0, 1, 0, 1, 0,
+        1, 0, 1, 0, -48, -42307, -35384, 1,
+        0, 1, 0, 0, 0, 0, 0, 0,
+        1, 0, 0, 0, 0, 0, 1, 0,
+        1, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 1, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 0FF00 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 32, 32, 32, 32, 32, 32, 32,
+        32, 32, 32, 32, 32, 32, 32, 32,
+        32, 32, 32, 32, 32, 32, 32, 32,
+        32, 32, 32, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 10400 */
+        40, 40, 40, 40, 40, 40, 40, 40,
+        40, 40, 40, 40, 40, 40, 40, 40,
+        40, 40, 40, 40, 40, 40, 40, 40,
+        40, 40, 40, 40, 40, 40, 40, 40,
+        40, 40, 40, 40, 40, 40, 40, 40,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 10480 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        40, 40, 40, 40, 40, 40, 40, 40,
+        40, 40, 40, 40, 40, 40, 40, 40,
+        40, 40, 40, 40, 40, 40, 40, 40,
+        40, 40, 40, 40, 40, 40, 40, 40,
+        40, 40, 40, 40, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 10500 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        39, 39, 39, 39, 39, 39, 39, 39,
+        39, 39, 39, 0, 39, 39, 39, 39,
+    },
+    {   /* 10580 */
+        39, 39, 39, 39, 39, 39, 39, 39,
+        39, 39, 39, 0, 39, 39, 39, 39,
+        39, 39, 39, 0, 39, 39, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 10C80 */
+        64, 64, 64, 64, 64, 64, 64, 64,
+        64, 64, 64, 64, 64, 64, 64, 64,
+        64, 64, 64, 64, 64, 64, 64, 64,
+        64, 64, 64, 64, 64, 64, 64, 64,
+        64, 64, 64, 64, 64, 64, 64, 64,
+        64, 64, 64, 64, 64, 64, 64, 64,
+        64, 64, 64, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 11880 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        32, 32, 32, 32, 32, 32, 32, 32,
+        32, 32, 32, 32, 32, 32, 32, 32,
+        32, 32, 32, 32, 32, 32, 32, 32,
+        32, 32, 32, 32, 32, 32, 32, 32,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 16E00 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        32, 32, 32, 32, 32, 32, 32, 32,
+        32, 32, 32, 32, 32, 32, 32, 32,
+        32, 32, 32, 32, 32, 32, 32, 32,
+        32, 32, 32, 32, 32, 32, 32, 32,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 1E900 */
+        34, 34, 34, 34, 34, 34, 34, 34,
+        34, 34, 34, 34, 34, 34, 34, 34,
+        34, 34, 34, 34, 34, 34, 34, 34,
+        34, 34, 34, 34, 34, 34, 34, 34,
+        34, 34, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+};
+
+/* accent stripping, diacritics fold to 0 */
+static unsigned char const unicode_fold_accent_index[1024] = {
+      0,   1,   2,   3,   4,   0,   5,   6,   7,   8,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   9,   0,   0,   0,   0,   0,  10,  11,  12,  13,  14,
+     15,  16,  17,  18,  19,  20,  21,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,  22,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,  23,  24,  25,  26,   0,   0,   0,   0,   0,   0,  27,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+static int const unicode_fold_accent[28][128] = {
+    {   /* 00000 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 00080 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        -127, -128, -129, -130, -131, -132, 0, -132,
+        -131, -132, -133, -134, -131, -132, -133, -134,
+        0, -131, -131, -132, -133, -134, -135, 0,
+        0, -132, -133, -134, -135, -132, 0, 0,
+        -127, -128, -129, -130, -131, -132, 0, -132,
+        -131, -132, -133, -134, -131, -132, -133, -134,
+        0, -131, -131, -132, -133, -134, -135, 0,
+        0, -132, -133, -134, -135, -132, 0, -134,
+    },
+    {   /* 00100 */
+        -191, -160, -193, -162, -195, -164, -195, -164,
+        -197, -166, -199, -168, -201, -170, -202, -171,
+        0, 0, -205, -174, -207, -176, -209, -178,
+        -211, -180, -213, -182, -213, -182, -215, -184,
+        -217, -186, -219, -188, -220, -189, 0, 0,
+        -223, -192, -225, -194, -227, -196, -229, -198,
+        -231, 0, 0, 0, -234, -203, -235, -204,
+        0, -237, -206, -239, -208, -241, -210, 0,
+        0, 0, 0, -245, -214, -247, -216, -249,
+        -218, 0, 0, 0, -253, -222, -255, -224,
+        -257, -226, 0, 0, -258, -227, -260, -229,
+        -262, -231, -263, -232, -265, -234, -267, -236,
+        -269, -238, -270, -239, -272, -241, 0, 0,
+        -275, -244, -277, -246, -279, -248, -281, -250,
+        -283, -252, -285, -254, -285, -254, -285, -254,
+        -287, -287, -256, -289, -258, -291, -260, 0,
+    },
+    {   /* 00180 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        -337, -306, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, -346,
+        -315, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, -396, -365, -390,
+        -359, -386, -355, -382, -351, -384, -353, -386,
+        -355, -388, -357, -390, -359, 0, -413, -382,
+        -415, -384, -284, -253, 0, 0, -415, -384,
+        -413, -382, -411, -380, -413, -382, -55, 163,
+        -390, 0, 0, 0, -429, -398, 0, 0,
+        -426, -395, -441, -410, -310, -279, -294, -263,
+    },
+    {   /* 00200 */
+        -447, -416, -449, -418, -447, -416, -449, -418,
+        -447, -416, -449, -418, -445, -414, -447, -416,
+        -446, -415, -448, -417, -447, -416, -449, -418,
+        -453, -422, -454, -423, 0, 0, -470, -439,
+        0, 0, 0, 0, 0, 0, -485, -454,
+        -483, -452, -475, -444, -477, -446, -479, -448,
+        -481, -450, -473, -442, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 00300 */
+        -768, -769, -770, -771, -772, -773, -774, -775,
+        -776, -777, -778, -779, -780, -781, -782, -783,
+        -784, -785, -786, -787, -788, -789, -790, -791,
+        -792, -793, -794, -795, -796, -797, -798, -799,
+        -800, -801, -802, -803, -804, -805, -806, -807,
+        -808, -809, -810, -811, -812, -813, -814, -815,
+        -816, -817, -818, -819, -820, -821, -822, -823,
+        -824, -825, -826, -827, -828, -829, -830, -831,
+        -832, -833, -834, -835, -836, -837, -838, -839,
+        -840, -841, -842, -843, -844, -845, -846, -847,
+        -848, -849, -850, -851, -852, -853, -854, -855,
+        -856, -857, -858, -859, -860, -861, -862, -863,
+        -864, -865, -866, -867, -868, -869, -870, -871,
+        -872, -873, -874, -875, -876, -877, -878, -879,
+        0, 0, 0, 0, -187, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, -835, 0,
+    },
+    {   /* 00380 */
+        0, 0, 0, 0, 0, -733, 11, -720,
+        13, 14, 15, 0, 19, 0, 23, 26,
+        41, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, -17, -6, 5, 8, 9, 10,
+        21, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, -17, -6, -13, -8, -5, 0,
+        0, 0, 0, -1, -2, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 00400 */
+        21, 20, 0, 16, 0, 0, 0, -1,
+        0, 0, 0, 0, 14, 11, 21, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, -1, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, -1, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        -27, -28, 0, -32, 0, 0, 0, -1,
+        0, 0, 0, 0, -34, -37, -27, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, -2, -2,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 00480 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, -171, -140, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        -192, -161, -194, -163, 0, 0, -193, -162,
+        0, 0, -2, -2, -198, -167, -199, -168,
+        0, 0, -202, -171, -204, -173, -200, -169,
+        0, 0, -2, -2, -191, -160, -203, -172,
+        -205, -174, -207, -176, -205, -174, 0, 0,
+        -205, -174, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 01A80 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        -6832, -6833, -6834, -6835, -6836, -6837, -6838, -6839,
+        -6840, -6841, -6842, -6843, -6844, -6845, -6846, -6847,
+        -6848, -6849, -6850, -6851, -6852, -6853, -6854, -6855,
+        -6856, -6857, -6858, -6859, -6860, -6861, -6862, -6863,
+        -6864, -6865, -6866, -6867, -6868, -6869, -6870, -6871,
+        -6872, -6873, -6874, -6875, -6876, -6877, -6878, -6879,
+        -6880, -6881, -6882, -6883, -6884, -6885, -6886, -6887,
+        -6888, -6889, -6890, -6891, -6892, -6893, -6894, -6895,
+        -6896, -6897, -6898, -6899, -6900, -6901, -6902, -6903,
+        -6904, -6905, -6906, -6907, -6908, -6909, -6910, -6911,
+    },
+    {   /* 01D80 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        -7616, -7617, -7618, -7619, -7620, -7621, -7622, -7623,
+        -7624, -7625, -7626, -7627, -7628, -7629, -7630, -7631,
+        -7632, -7633, -7634, -7635, -7636, -7637, -7638, -7639,
+        -7640, -7641, -7642, -7643, -7644, -7645, -7646, -7647,
+        -7648, -7649, -7650, -7651, -7652, -7653, -7654, -7655,
+        -7656, -7657, -7658, -7659, -7660, -7661, -7662, -7663,
+        -7664, -7665, -7666, -7667, -7668, -7669, -7670, -7671,
+        -7672, -7673, -7674, -7675, -7676, -7677, -7678, -7679,
+    },
+    {   /* 01E00 */
+        -7615, -7584, -7616, -7585, -7618, -7587, -7620, -7589,
+        -7621, -7590, -7622, -7591, -7624, -7593, -7626, -7595,
+        -7628, -7597, -7630, -7599, -7631, -7600, -7633, -7602,
+        -7635, -7604, -7637, -7606, -7639, -7608, -7640, -7609,
+        -7641, -7610, -7642, -7611, -7644, -7613, -7646, -7615,
+        -7648, -7617, -7650, -7619, -7651, -7620, -7653, -7622,
+        -7653, -7622, -7655, -7624, -7657, -7626, -7658, -7627,
+        -7660, -7629, -7662, -7631, -7664, -7633, -7665, -7634,
+        -7667, -7636, -7669, -7638, -7670, -7639, -7672, -7641,
+        -7674, -7643, -7676, -7645, -7677, -7646, -7679, -7648,
+        -7681, -7650, -7683, -7652, -7684, -7653, -7686, -7655,
+        -7686, -7655, -7688, -7657, -7690, -7659, -7692, -7661,
+        -7693, -7662, -7695, -7664, -7697, -7666, -7699, -7668,
+        -7701, -7670, -7702, -7671, -7704, -7673, -7706, -7675,
+        -7708, -7677, -7709, -7678, -7711, -7680, -7713, -7682,
+        -7715, -7684, -7717, -7686, -7718, -7687, -7720, -7689,
+    },
+    {   /* 01E80 */
+        -7721, -7690, -7723, -7692, -7725, -7694, -7727, -7696,
+        -7729, -7698, -7730, -7699, -7732, -7701, -7733, -7702,
+        -7734, -7703, -7736, -7705, -7738, -7707, -7726, -7715,
+        -7713, -7712, 0, -7452, 0, 0, 0, 0,
+        -7775, -7744, -7777, -7746, -7779, -7748, -7781, -7750,
+        -7783, -7752, -7785, -7754, -7787, -7756, -7789, -7758,
+        -7791, -7760, -7793, -7762, -7795, -7764, -7797, -7766,
+        -7795, -7764, -7797, -7766, -7799, -7768, -7801, -7770,
+        -7803, -7772, -7805, -7774, -7807, -7776, -7809, -7778,
+        -7807, -7776, -7809, -7778, -7805, -7774, -7807, -7776,
+        -7809, -7778, -7811, -7780, -7813, -7782, -7815, -7784,
+        -7817, -7786, -7819, -7788, -7821, -7790, -7823, -7792,
+        -7825, -7794, -7827, -7796, -7823, -7792, -7825, -7794,
+        -7827, -7796, -7829, -7798, -7831, -7800, -7833, -7802,
+        -7835, -7804, -7833, -7802, -7835, -7804, -7837, -7806,
+        -7839, -7808, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 01F00 */
+        -6991, -6992, -6993, -6994, -6995, -6996, -6997, -6998,
+        -7031, -7032, -7033, -7034, -7035, -7036, -7037, -7038,
+        -7003, -7004, -7005, -7006, -7007, -7008, 0, 0,
+        -7043, -7044, -7045, -7046, -7047, -7048, 0, 0,
+        -7017, -7018, -7019, -7020, -7021, -7022, -7023, -7024,
+        -7057, -7058, -7059, -7060, -7061, -7062, -7063, -7064,
+        -7031, -7032, -7033, -7034, -7035, -7036, -7037, -7038,
+        -7071, -7072, -7073, -7074, -7075, -7076, -7077, -7078,
+        -7041, -7042, -7043, -7044, -7045, -7046, 0, 0,
+        -7081, -7082, -7083, -7084, -7085, -7086, 0, 0,
+        -7051, -7052, -7053, -7054, -7055, -7056, -7057, -7058,
+        0, -7092, 0, -7094, 0, -7096, 0, -7098,
+        -7063, -7064, -7065, -7066, -7067, -7068, -7069, -7070,
+        -7103, -7104, -7105, -7106, -7107, -7108, -7109, -7110,
+        -7103, -7104, -7101, -7102, -7101, -7102, -7101, -7102,
+        -7097, -7098, -7093, -7094, -7091, -7092, 0, 0,
+    },
+    {   /* 01F80 */
+        -7119, -7120, -7121, -7122, -7123, -7124, -7125, -7126,
+        -7159, -7160, -7161, -7162, -7163, -7164, -7165, -7166,
+        -7129, -7130, -7131, -7132, -7133, -7134, -7135, -7136,
+        -7169, -7170, -7171, -7172, -7173, -7174, -7175, -7176,
+        -7127, -7128, -7129, -7130, -7131, -7132, -7133, -7134,
+        -7167, -7168, -7169, -7170, -7171, -7172, -7173, -7174,
+        -7167, -7168, -7169, -7170, -7171, 0, -7173, -7174,
+        -7207, -7208, -7209, -7210, -7211, 0, -7173, 0,
+        0, -7961, -7179, -7180, -7181, 0, -7183, -7184,
+        -7219, -7220, -7219, -7220, -7221, -14, -15, -16,
+        -7191, -7192, -7193, -7194, 0, 0, -7197, -7198,
+        -7231, -7232, -7233, -7234, 0, 33, 32, 31,
+        -7195, -7196, -7197, -7198, -7203, -7204, -7201, -7202,
+        -7235, -7236, -7237, -7238, -7243, -8005, -8006, -8079,
+        0, 0, -7209, -7210, -7211, 0, -7213, -7214,
+        -7257, -7258, -7249, -7250, -7251, -8009, 0, 0,
+    },
+    {   /* 02000 */
+        2, 2, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 02080 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        -8400, -8401, -8402, -8403, -8404, -8405, -8406, -8407,
+        -8408, -8409, -8410, -8411, -8412, -8413, -8414, -8415,
+        -8416, -8417, -8418, -8419, -8420, -8421, -8422, -8423,
+        -8424, -8425, -8426, -8427, -8428, -8429, -8430, -8431,
+        -8432, -8433, -8434, -8435, -8436, -8437, -8438, -8439,
+        -8440, -8441, -8442, -8443, -8444, -8445, -8446, -8447,
+    },
+    {   /* 02100 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, -7549, 0,
+        0, 0, -8415, -8426, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 02180 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, -10, -9, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, -26, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 3, 6, 3,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 02200 */
+        0, 0, 0, 0, -1, 0, 0, 0,
+        0, -1, 0, 0, -1, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, -1, 0, -1, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, -5, 0, 0, -1, 0, 0, -2,
+        0, -1, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        -8739, 0, -1, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, -32, -8754, -8753,
+        -12, -12, 0, 0, -2, -2, 0, 0,
+        -2, -2, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 02280 */
+        -6, -6, 0, 0, -2, -2, 0, 0,
+        -2, -2, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, -10, -5, -5, -4,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        -100, -100, -81, -81, 0, 0, 0, 0,
+        0, 0, -56, -56, -56, -56, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 02300 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 3295, 3295, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 02A80 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 1, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 0F900 */
+        -27832, -37389, -27192, -27707, -35379, -43731, -42273, -22891,
+        -22892, -40888, -26425, -41860, -40900, -38679, -33445, -31114,
+        -29393, -29015, -28698, -26756, -36626, -35834, -34877, -34105,
+        -29915, -26543, -24361, -43673, -42407, -36377, -34563, -29426,
+        -23298, -39889, -35127, -29526, -28608, -38492, -30542, -28936,
+        -39518, -37394, -35776, -34351, -26718, -43431, -42871, -42577,
+        -37996, -36446, -34594, -33356, -31027, -29487, -29402, -27464,
+        -25094, -24010, -23360, -32943, -32701, -31645, -30069, -26171,
+        -23233, -28267, -41059, -39487, -31972, -30919, -34532, -32893,
+        -27782, -25170, -41074, -40169, -36665, -35699, -35391, -31776,
+        -31513, -25350, -42624, -30920, -42872, -42889, -32570, -31641,
+        -30055, -25316, -28122, -38540, -36698, -28255, -43813, -40312,
+        -39246, -34266, -33778, -42572, -32873, -43430, -39357, -43866,
+        -35996, -37873, -31816, -42408, -41230, -33388, -29989, -28357,
+        -36278, -27073, -36074, -38517, -30351, -38357, -33809, -43721,
+        -43023, -42928, -37113, -31892, -30477, -28331, -26543, -42634,
+    },
+    {   /* 0F980 */
+        -42302, -40974, -39574, -37822, -35206, -32859, -25561, -24349,
+        -23281, -23227, -42735, -37573, -36373, -27179, -39706, -38911,
+        -38800, -38135, -35439, -34890, -34059, -32715, -31650, -31016,
+        -27250, -29867, -26999, -26193, -42885, -42746, -42209, -35031,
+        -28894, -28407, -39641, -39342, -38441, -36343, -32104, -34354,
+        -43716, -41648, -40387, -39921, -39312, -34299, -34117, -31253,
+        -31082, -26493, -25276, -25195, -24988, -43562, -32776, -26627,
+        -25344, -39128, -43828, -43233, -40398, -40318, -37925, -36797,
+        -34802, -33663, -29894, -26951, -23095, -37693, -25496, -42814,
+        -37453, -37334, -35977, -35631, -34243, -33908, -33123, -31935,
+        -24946, -43108, -38820, -25435, -43433, -40124, -35820, -27309,
+        -39501, -39061, -37315, -34388, -25430, -42932, -42447, -40314,
+        -37837, -37523, -37178, -36094, -34270, -33795, -31341, -28952,
+        -28935, -26653, -25352, -42668, -35634, -42448, -34846, -34135,
+        -29686, -25422, -23963, -23380, -37469, -35882, -30734, -32556,
+        -32472, -32103, -34618, -35170, -28324, -43837, -30408, -42949,
+    },
+    {   /* 0FA00 */
+        -43001, -39771, -38703, -32045, -40575, -36071, -37714, -27340,
+        -29116, -25532, -28799, -39736, -43212, -42061, 0, 0,
+        -41398, 0, -37790, 0, 0, -43063, -34540, -33613,
+        -32988, -32955, -32949, -32908, -25286, -32095, -31329, 0,
+        -29710, 0, -28458, 0, 0, -27117, -26921, 0,
+        0, 0, -24891, -24879, -24836, -23673, -26960, -25464,
+        -43650, -43338, -43237, -42858, -42832, -42724, -42137, -42033,
+        -41936, -41465, -41362, -40407, -40398, -39337, -39126, -39089,
+        -38990, -38130, -37984, -37810, -37311, -36046, -35884, -35621,
+        -35034, -34846, -34344, -33210, -33038, -33028, -33030, -33023,
+        -33018, -33012, -32965, -32965, -32788, -32724, -32406, -31843,
+        -31823, -31768, -31464, -31318, -30831, -30692, -30693, -30216,
+        -29008, -28875, -28513, -28458, -28049, -27997, -27312, -27183,
+        -25477, -25194, -25135, -39414, 0, -30805, 0, 0,
+        -44106, -43196, -43274, -43763, -43311, -43253, -42927, -42877,
+        -42203, -42276, -42209, -42137, -41506, -41418, -41274, -41259,
+    },
+    {   /* 0FA80 */
+        -40990, -40793, -39856, -39850, -39707, -39640, -39342, -39225,
+        -39296, -39163, -39210, -39065, -39000, -38601, -38514, -38461,
+        -38202, -37917, -37755, -37752, -37694, -36636, -36572, -36182,
+        -35773, -35790, -35704, -35453, -35118, -33526, -34921, -34800,
+        -34678, -34352, -34204, -34152, -33927, -33926, -33756, -33740,
+        -33716, -33631, -33642, -33247, -32763, -32493, -32307, -32084,
+        -31932, -31603, -31405, -30561, -30405, -29500, -29045, -28977,
+        -28962, -28666, -28610, -28656, -28603, -28607, -28625, -28550,
+        -28470, -28089, -27530, -27217, -26923, -26703, -25674, -25572,
+        -25458, -25326, -25291, -25280, -25233, -24507, -23346, 0,
+        0, 0, -48949, -47803, -47771, 0, 0, 0,
+        -23445, -23371, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+    {   /* 0FE00 */
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        -65056, -65057, -65058, -65059, -65060, -65061, -65062, -65063,
+        -65064, -65065, -65066, -65067, -65068, -65069, -65070, -65071,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+    },
+};
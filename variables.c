@@ -60,6 +60,10 @@ static VarDef var_table[] = {
            "Size from which files are mmapped instead of loaded in memory." )
     S_VAR( "max-load-size", max_load_size, VAR_NUMBER, VAR_RW_SAVE,
            "Maximum size for files to be loaded or mmapped into a buffer." )
+    S_VAR( "search-index-save", search_index_save, VAR_NUMBER, VAR_RW_SAVE,
+           "Set to save the search index of mmapped files alongside them." )
+    S_VAR( "search-accent-fold", search_accent_fold, VAR_NUMBER, VAR_RW_SAVE,
+           "Set to ignore accents and diacritics in searches by default." )
     S_VAR( "show-unicode", show_unicode, VAR_NUMBER, VAR_RW_SAVE,
            "Set to show non-ASCII characters as unicode escape sequences." )
     S_VAR( "default-tab-width", default_tab_width, VAR_NUMBER, VAR_RW_SAVE,
@@ -68,6 +72,16 @@ static VarDef var_table[] = {
            "Default value of `fill-column` for buffers that do not override it" )
     S_VAR( "backup-inhibited", backup_inhibited, VAR_NUMBER, VAR_RW_SAVE,
            "Set to prevent automatic backups of modified files" )
+    S_VAR( "redisplay-fps", redisplay_fps, VAR_NUMBER, VAR_RW_SAVE,
+           "Maximum number of screen updates per second for process output." )
+    S_VAR( "display-stats-timing", display_stats_timing, VAR_NUMBER, VAR_RW,
+           "Set to time the display stages reported by describe-display-stats." )
+    S_VAR( "tty-low-bandwidth", tty_low_bandwidth, VAR_NUMBER, VAR_RW_SAVE,
+           "Terminal throughput in bytes per second below which colors are not output, 0 to disable." )
+    S_VAR( "shell-scrollback-lines", shell_scrollback_lines, VAR_NUMBER, VAR_RW_SAVE,
+           "Maximum number of lines kept in shell and compilation buffers, 0 for no limit." )
+    S_VAR( "shell-scrollback-size", shell_scrollback_size, VAR_NUMBER, VAR_RW_SAVE,
+           "Maximum number of bytes kept in shell and compilation buffers, 0 for no limit." )
     S_VAR( "c-label-indent", c_label_indent, VAR_NUMBER, VAR_RW_SAVE,
            "Number of columns to adjust indentation of C labels." )
 